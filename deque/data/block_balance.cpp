@@ -0,0 +1,94 @@
+#include "deque1.hpp"
+
+#include <iostream>
+#include <deque>
+#include <string>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+
+template<class T, int B>
+bool balanced(const sjtu::deque<T, B> &d) { //every block between the first and the last is at least half full
+	typedef typename sjtu::deque<T, B>::block block;
+	int total = 0, count = 0;
+	for (block *p = d.head->next; p != d.tail; p = p->next, ++count) {
+		if (p->len <= 0 || p->len > p->size) return false;
+		if (p->last != d.head && p->next != d.tail && p->len < p->size / 2) return false;
+		total += p->len;
+	}
+	return total == (int) d.size() && count == d.blocknum;
+}
+
+bool check1() { //random middle inserts and erases against std::deque, checking the block shapes as they go
+	sjtu::deque<std::string, 16> d;
+	std::deque<std::string> ref;
+	srand(44);
+	for (int i = 0; i < 200000; ++i) {
+		int op = rand() % 10;
+		std::string s = std::to_string(rand());
+		if (op <= 3 || ref.empty()) {
+			int k = rand() % (ref.size() + 1);
+			d.insert(d.begin() + k, s);
+			ref.insert(ref.begin() + k, s);
+		}
+		else if (op <= 7) {
+			int k = rand() % ref.size();
+			d.erase(d.begin() + k);
+			ref.erase(ref.begin() + k);
+		}
+		else if (op == 8) d.push_front(s), ref.push_front(s), d.pop_back(), ref.pop_back();
+		else d.push_back(s), ref.push_back(s), d.pop_front(), ref.pop_front();
+		if (i % 1000 == 0 && !balanced(d)) return false;
+	}
+	if (d.size() != ref.size() || !balanced(d)) return false;
+	for (int i = 0; i < (int) ref.size(); ++i) if (d[i] != ref[i]) return false;
+	return true;
+}
+
+bool check2() { //erasing every other element keeps the block count near size / (B / 2)
+	sjtu::deque<int, 64> d;
+	for (int i = 0; i < 100000; ++i) d.push_back(i);
+	for (int i = 0; i < 50000; ++i) d.erase(d.begin() + i);
+	for (int i = 0; i < 50000; ++i) if (d[i] != 2 * i + 1) return false;
+	printf("%d blocks for %d ints ", d.blocknum, (int) d.size());
+	return balanced(d) && d.blocknum <= 50000 / 32 + 2;
+}
+
+bool check3() { //timing of middle edits
+	const int N = 100000, Q = 100000;
+	sjtu::deque<long long> d;
+	for (int i = 0; i < N; ++i) d.push_back(i);
+	clock_t t = clock();
+	for (int i = 0; i < Q; ++i) {
+		d.insert(d.begin() + rand() % (int) d.size(), i);
+		d.erase(d.begin() + rand() % (int) d.size());
+	}
+	printf("%d middle insert/erase pairs on %d elements: %.3fs ", Q, N, (double) (clock() - t) / CLOCKS_PER_SEC);
+	return (int) d.size() == N && balanced(d);
+}
+
+bool check4() { //inserting a copy of an element of the deque itself, in a block that shifts or splits
+	sjtu::deque<std::string, 16> d;
+	std::deque<std::string> ref;
+	for (int i = 0; i < 10; ++i) d.push_back("s" + std::to_string(i)), ref.push_back("s" + std::to_string(i));
+	d.insert(d.begin() + 3, d[5]);
+	ref.insert(ref.begin() + 3, std::string(ref[5]));
+	if (d[3] != "s5" || d[6] != "s5" || d[4] != "s3") return false;
+	srand(4);
+	for (int i = 0; i < 2000; ++i) {
+		int k = rand() % (ref.size() + 1), j = rand() % ref.size();
+		d.insert(d.begin() + k, d[j]);
+		ref.insert(ref.begin() + k, std::string(ref[j]));
+	}
+	if (d.size() != ref.size() || !balanced(d)) return false;
+	for (int i = 0; i < (int) ref.size(); ++i) if (d[i] != ref[i]) return false;
+	return true;
+}
+
+int main() {
+	if (!check1()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check3()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	if (!check4()) std::cout << "Test 4 Failed......" << std::endl; else std::cout << "Test 4 Passed!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,73 @@
+#include "deque1.hpp"
+
+#include <iostream>
+#include <deque>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+
+template<class T, int B>
+bool consistent(const sjtu::deque<T, B> &d) { //a clean directory lists the blocks in order with their lengths and prefix sums
+	if (d.dirty) return true;
+	typedef typename sjtu::deque<T, B>::block block;
+	int i = 0, sum = 0;
+	for (block *p = d.head->next; p != d.tail; p = p->next, ++i) {
+		if (i >= d.dirnum || d.dir[i] != p || p->id != i || d.lens[i] != p->len) return false;
+		sum += p->len;
+		if (d.prefix(i + 1) != sum) return false;
+	}
+	return i == d.dirnum;
+}
+
+bool check1() { //lookups interleaved with every kind of edit, at both ends and in the middle
+	sjtu::deque<long long, 16> d;
+	std::deque<long long> ref;
+	srand(46);
+	for (int i = 0; i < 300000; ++i) {
+		int op = rand() % 12;
+		long long x = rand();
+		if (op <= 2) d.push_back(x), ref.push_back(x);
+		else if (op == 3) d.push_front(x), ref.push_front(x);
+		else if (op == 4 && !ref.empty()) d.pop_back(), ref.pop_back();
+		else if (op == 5 && !ref.empty()) d.pop_front(), ref.pop_front();
+		else if (op <= 7) {
+			int k = rand() % (ref.size() + 1);
+			d.insert(d.begin() + k, x);
+			ref.insert(ref.begin() + k, x);
+		}
+		else if (op == 8 && !ref.empty()) {
+			int k = rand() % ref.size();
+			d.erase(d.begin() + k);
+			ref.erase(ref.begin() + k);
+		}
+		else if (!ref.empty()) {
+			int k = rand() % ref.size();
+			if (d[k] != ref[k] || d.at(k) != ref[k] || *(d.cbegin() + k) != ref[k]) return false;
+		}
+		if (i % 1000 == 0 && !consistent(d)) return false;
+		if (i % 50000 == 0) d.clear(), ref.clear();
+	}
+	for (int i = 0; i < (int) ref.size(); ++i) if (d[i] != ref[i]) return false;
+	return consistent(d);
+}
+
+bool check2() { //random reads on a long deque with small blocks
+	const int N = 1000000, Q = 2000000;
+	sjtu::deque<int, 64> d;
+	for (int i = 0; i < N; ++i) d.push_back(i);
+	clock_t t = clock();
+	long long sum = 0, expect = 0;
+	for (int i = 0; i < Q; ++i) {
+		int k = rand() % N;
+		sum += d[k];
+		expect += k;
+	}
+	printf("%d random reads over %d blocks: %.3fs ", Q, d.blocknum, (double) (clock() - t) / CLOCKS_PER_SEC);
+	return sum == expect && consistent(d);
+}
+
+int main() {
+	if (!check1()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	return 0;
+}
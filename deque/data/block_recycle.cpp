@@ -0,0 +1,114 @@
+#include "deque1.hpp"
+
+#include <iostream>
+#include <deque>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+long long allocations = 0;
+
+void *operator new(size_t n) {
+	++allocations;
+	void *p = malloc(n ? n : 1);
+	if (p == nullptr) throw std::bad_alloc();
+	return p;
+}
+void operator delete(void *p) noexcept {
+	free(p);
+}
+void operator delete(void *p, size_t) noexcept {
+	free(p);
+}
+
+bool check1() { //an oscillating queue stops allocating once it has warmed up
+	sjtu::deque<long long> d;
+	for (int round = 0; round < 3; ++round) {
+		for (int i = 0; i < 50000; ++i) d.push_back(i);
+		for (int i = 0; i < 50000; ++i) d.pop_front();
+	}
+	long long before = allocations, sum = 0;
+	for (int round = 0; round < 20; ++round) {
+		for (int i = 0; i < 50000; ++i) d.push_back(i);
+		for (int i = 0; i < 25000; ++i) sum += d.front(), d.pop_front();
+		for (int i = 0; i < 25000; ++i) d.push_front(i), d.pop_back();
+		for (int i = 0; i < 25000; ++i) d.pop_back();
+	}
+	printf("allocations in steady state: %lld ", allocations - before);
+	return allocations == before && sum == 20LL * 24999 * 25000 / 2;
+}
+
+bool check2() { //contents stay right while blocks are recycled; clear and shrink_to_fit release them
+	sjtu::deque<std::string, 16> d;
+	std::deque<std::string> ref;
+	for (int i = 0; i < 100000; ++i) {
+		int op = rand() % 7;
+		std::string s = std::to_string(rand());
+		if (op <= 1) d.push_back(s), ref.push_back(s);
+		else if (op == 2) d.push_front(s), ref.push_front(s);
+		else if (op == 3 && !ref.empty()) d.pop_back(), ref.pop_back();
+		else if (op == 4 && !ref.empty()) d.pop_front(), ref.pop_front();
+		else if (op == 5) {
+			int k = rand() % (ref.size() + 1);
+			d.insert(d.begin() + k, s);
+			ref.insert(ref.begin() + k, s);
+		}
+		else if (!ref.empty()) {
+			int k = rand() % ref.size();
+			d.erase(d.begin() + k);
+			ref.erase(ref.begin() + k);
+		}
+		if (i % 20000 == 0) {
+			sjtu::deque<std::string, 16> e(d);
+			d.clear();
+			d = e;
+		}
+	}
+	if (d.size() != ref.size()) return false;
+	for (int i = 0; i < (int) ref.size(); ++i) if (d[i] != ref[i]) return false;
+	d.clear();
+	if (d.sparenum == 0 || d.sparenum > d.peak) return false;
+	d.shrink_to_fit();
+	return d.sparenum == 0 && d.spare == nullptr && d.empty();
+}
+
+bool check3() { //empty deques are small and never touch the heap
+	long long before = allocations;
+	sjtu::deque<long long> *many = (sjtu::deque<long long>*) malloc(100000 * sizeof(sjtu::deque<long long>));
+	for (int i = 0; i < 100000; ++i) new(many + i) sjtu::deque<long long>();
+	bool ok = allocations == before;
+	for (int i = 0; i < 100000; i += 1000) {
+		many[i].push_back(i);
+		many[i].pop_front();
+	}
+	for (int i = 0; i < 100000; ++i) {
+		sjtu::deque<long long> copy(many[i]);
+		ok = ok && copy.empty();
+		many[i].~deque();
+	}
+	free(many);
+	printf("sizeof(deque) = %d ", (int) sizeof(sjtu::deque<long long>));
+	return ok;
+}
+
+bool check4() { //a deque that has shrunk for good gives its spare blocks back once it is used a little
+	sjtu::deque<int, 16> d;
+	for (int i = 0; i < 200000; ++i) d.push_back(i);
+	d.clear();
+	if (d.sparenum < 10000) return false;
+	for (int round = 0; round < 30000; ++round) { //one block taken and given back per round
+		for (int i = 0; i < 16; ++i) d.push_back(i);
+		for (int i = 0; i < 16; ++i) d.pop_front();
+	}
+	printf("spare blocks after shrinking: %d ", d.sparenum);
+	return d.sparenum <= d.SPARE_LIMIT && d.empty();
+}
+
+int main() {
+	if (!check1()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check3()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	if (!check4()) std::cout << "Test 4 Failed......" << std::endl; else std::cout << "Test 4 Passed!" << std::endl;
+	return 0;
+}
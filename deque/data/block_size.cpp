@@ -0,0 +1,64 @@
+#include "deque1.hpp"
+
+#include <iostream>
+#include <deque>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+
+struct Wide { //a 256-byte element
+	long long a[32];
+	Wide(long long x = 0) { for (int i = 0; i < 32; ++i) a[i] = x; }
+};
+
+long long value(int x) { return x; }
+long long value(const Wide &x) { return x.a[31]; }
+
+double seconds(clock_t t) {
+	return (double) (clock() - t) / CLOCKS_PER_SEC;
+}
+
+template<class T, int B>
+bool sweep(const char *name) { //push_back, random indexing and random insertion at one block size
+	const int N = 200000, Q = 20000, I = 2000;
+	sjtu::deque<T, B> d;
+	std::deque<long long> ref;
+	srand(B);
+	clock_t t = clock();
+	for (int i = 0; i < N; ++i) {
+		if (i % 2) d.push_back(T(i)), ref.push_back(i);
+		else d.push_front(T(i)), ref.push_front(i);
+	}
+	double push = seconds(t);
+	t = clock();
+	long long sum = 0, expect = 0;
+	for (int i = 0; i < Q; ++i) {
+		int k = rand() % N;
+		sum += value(d[k]);
+		expect += ref[k];
+	}
+	double index = seconds(t);
+	t = clock();
+	for (int i = 0; i < I; ++i) {
+		int k = rand() % (int) ref.size();
+		d.insert(d.begin() + k, T(-i));
+		ref.insert(ref.begin() + k, -i);
+	}
+	double insert = seconds(t);
+	for (int i = 0; i < (int) ref.size(); i += 997) if (value(d[i]) != ref[i]) return false;
+	printf("%-6s B = %5d  push %.3fs  index %.3fs  insert %.3fs\n", name, B, push, index, insert);
+	return sum == expect;
+}
+
+template<class T>
+bool sweep_all(const char *name) {
+	bool ok = sweep<T, 16>(name) && sweep<T, 64>(name) && sweep<T, 256>(name) && sweep<T, 1024>(name) && sweep<T, 4096>(name);
+	return sweep<T, sjtu::deque_block<T>::value>(name) && ok;
+}
+
+int main() {
+	printf("default block: %d ints, %d Wides\n", sjtu::deque_block<int>::value, sjtu::deque_block<Wide>::value);
+	if (!sweep_all<int>("int")) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!sweep_all<Wide>("Wide")) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	return 0;
+}
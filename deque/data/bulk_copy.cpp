@@ -0,0 +1,90 @@
+#include "deque1.hpp"
+
+#include <iostream>
+#include <deque>
+#include <string>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+
+template<class T, int B>
+bool packed(const sjtu::deque<T, B> &d) { //every block but the last is full
+	typedef typename sjtu::deque<T, B>::block block;
+	for (block *p = d.head->next; p != d.tail; p = p->next)
+		if (p->len != p->size && p->next != d.tail) return false;
+	return d.blocknum == ((int) d.size() + B - 1) / B;
+}
+
+template<class T>
+T make(int x) { return T(x); }
+template<>
+std::string make<std::string>(int x) { return std::to_string(x); }
+
+template<class T>
+bool copies() { //copies of a fragmented deque are equal, packed, and independent of the source
+	sjtu::deque<T, 32> a;
+	std::deque<T> ref;
+	srand(47);
+	for (int i = 0; i < 50000; ++i) {
+		int k = rand() % (ref.size() + 1);
+		a.insert(a.begin() + k, make<T>(i));
+		ref.insert(ref.begin() + k, make<T>(i));
+		if (i % 3 == 0) {
+			k = rand() % ref.size();
+			a.erase(a.begin() + k);
+			ref.erase(ref.begin() + k);
+		}
+	}
+	sjtu::deque<T, 32> b(a), c;
+	c.push_back(make<T>(-1));
+	c = b;
+	b.push_front(make<T>(-2));
+	a.pop_back();
+	if (c.size() != ref.size() || !packed(c) || !packed(sjtu::deque<T, 32>(a))) return false;
+	for (int i = 0; i < (int) ref.size(); ++i) if (c[i] != ref[i]) return false;
+	sjtu::deque<T, 32> e;
+	c = e;
+	b = b;
+	return c.empty() && b.size() == ref.size() + 1 && b[0] == make<T>(-2);
+}
+
+bool check1() {
+	return copies<int>() && copies<std::string>();
+}
+
+bool check2() { //assigning into a deque that already has blocks reuses them
+	sjtu::deque<int> a, b;
+	for (int i = 0; i < 100000; ++i) a.push_back(i), b.push_back(-i);
+	sjtu::deque<int>::block *first = b.head->next;
+	b = a;
+	bool ok = b.sparenum == 0 && b.head->next == first;
+	for (int i = 0; i < 100000; ++i) ok = ok && b[i] == i;
+	return ok;
+}
+
+bool check3() { //copy construction and assignment of a million ints
+	const int N = 1000000, R = 50;
+	sjtu::deque<int> a, c;
+	for (int i = 0; i < N; ++i) a.push_back(i);
+	clock_t t = clock();
+	long long sum = 0;
+	for (int r = 0; r < R; ++r) {
+		sjtu::deque<int> b(a);
+		sum += b.back();
+	}
+	double copy = (double) (clock() - t) / CLOCKS_PER_SEC;
+	t = clock();
+	for (int r = 0; r < R; ++r) {
+		c = a;
+		sum += c.back();
+	}
+	printf("%d copies of %d ints: construct %.3fs, assign %.3fs ", R, N, copy, (double) (clock() - t) / CLOCKS_PER_SEC);
+	return sum == 2LL * R * (N - 1);
+}
+
+int main() {
+	if (!check1()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check3()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	return 0;
+}
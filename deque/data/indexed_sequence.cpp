@@ -0,0 +1,191 @@
+#include "indexed_sequence.hpp"
+
+#include <iostream>
+#include <deque>
+#include <string>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+
+template<class S>
+int verify(typename S::node *p, bool root, int depth, int &leaf_depth) { //counts match, nodes at least half full, leaves level
+	if (p->leaf) {
+		if (leaf_depth == -1) leaf_depth = depth;
+		if (leaf_depth != depth || p->num <= 0 || (!root && p->num < S::capacity(p) / 2)) return -1;
+		return p->num;
+	}
+	typename S::inner_node *q = S::as_inner(p);
+	if (q->num > S::capacity(p) || q->num < (root ? 2 : S::capacity(p) / 2)) return -1;
+	int total = 0;
+	for (int i = 0; i < q->num; ++i) {
+		int c = verify<S>(q->child[i], false, depth + 1, leaf_depth);
+		if (c < 0 || c != q->cnt[i]) return -1;
+		total += c;
+	}
+	return total;
+}
+
+template<class S>
+bool valid(const S &s) {
+	int leaf_depth = -1;
+	return s.root == nullptr ? s.size() == 0 : verify<S>(s.root, true, 0, leaf_depth) == (int) s.size();
+}
+
+template<class S>
+bool random_ops(int steps) { //random edits at both ends and in the middle against std::deque
+	S d;
+	std::deque<std::string> ref;
+	srand(45);
+	for (int i = 0; i < steps; ++i) {
+		int op = rand() % 10;
+		std::string s = std::to_string(rand());
+		if (op <= 1) d.push_back(s), ref.push_back(s);
+		else if (op == 2) d.push_front(s), ref.push_front(s);
+		else if (op == 3 && !ref.empty()) d.pop_back(), ref.pop_back();
+		else if (op == 4 && !ref.empty()) d.pop_front(), ref.pop_front();
+		else if (op <= 6) {
+			int k = rand() % (ref.size() + 1);
+			if (d.insert(d.begin() + k, s) != d.begin() + k) return false;
+			ref.insert(ref.begin() + k, s);
+		}
+		else if (op <= 8 && !ref.empty()) {
+			int k = rand() % ref.size();
+			d.erase(d.begin() + k);
+			ref.erase(ref.begin() + k);
+		}
+		else if (!ref.empty()) {
+			int k = rand() % ref.size();
+			if (d[k] != ref[k] || *(d.cbegin() + k) != ref[k]) return false;
+		}
+		if (i % 5000 == 0) {
+			if (!valid(d)) return false;
+			S e(d);
+			d.clear();
+			d = e;
+		}
+	}
+	if (d.size() != ref.size() || !valid(d)) return false;
+	for (int i = 0; i < (int) ref.size(); ++i) if (d[i] != ref[i]) return false;
+	while (!ref.empty()) d.erase(d.begin() + ref.size() / 2), ref.erase(ref.begin() + ref.size() / 2);
+	return d.empty() && d.root == nullptr;
+}
+
+bool check1() { //tiny nodes make deep trees and exercise every split, merge and borrow
+	return random_ops<sjtu::indexed_sequence<std::string, 4, 4> >(200000) && random_ops<sjtu::indexed_sequence<std::string, 5, 7> >(200000);
+}
+
+bool check2() {
+	return random_ops<sjtu::indexed_sequence<std::string> >(200000);
+}
+
+bool check3() { //exceptions match sjtu::deque
+	sjtu::indexed_sequence<int> d, e;
+	int thrown = 0;
+	try { d.pop_back(); } catch (sjtu::container_is_empty &) { ++thrown; }
+	try { d.front(); } catch (sjtu::container_is_empty &) { ++thrown; }
+	try { d.at(0); } catch (sjtu::index_out_of_bound &) { ++thrown; }
+	try { d.insert(e.begin(), 1); } catch (sjtu::invalid_iterator &) { ++thrown; }
+	try { d.insert(d.begin() + 2, 1); } catch (sjtu::index_out_of_bound &) { ++thrown; }
+	d.push_back(1);
+	try { d.erase(d.end()); } catch (sjtu::index_out_of_bound &) { ++thrown; }
+	return thrown == 6 && d.back() == 1;
+}
+
+bool check4() { //random positional edits on a long sequence against sjtu::deque
+	const int N = 2000000, Q = 200000;
+	sjtu::indexed_sequence<int> s;
+	sjtu::deque<int> d;
+	for (int i = 0; i < N; ++i) s.push_back(i), d.push_back(i);
+	srand(4);
+	clock_t t0 = clock();
+	for (int i = 0; i < Q; ++i) {
+		s.insert(s.begin() + rand() % (int) s.size(), i);
+		s.erase(s.begin() + rand() % (int) s.size());
+	}
+	clock_t t1 = clock();
+	srand(4);
+	for (int i = 0; i < Q; ++i) {
+		d.insert(d.begin() + rand() % (int) d.size(), i);
+		d.erase(d.begin() + rand() % (int) d.size());
+	}
+	clock_t t2 = clock();
+	printf("%d insert/erase pairs on %d ints, depth %d: indexed_sequence %.3fs, deque %.3fs ", Q, N, s.depth(),
+		(double) (t1 - t0) / CLOCKS_PER_SEC, (double) (t2 - t1) / CLOCKS_PER_SEC);
+	for (int i = 0; i < N; i += 997) if (s[i] != d[i]) return false;
+	return valid(s);
+}
+
+int copies = 0;
+
+struct Counted { //counts copies
+	int x;
+	Counted(int v = 0): x(v) {}
+	Counted(const Counted &other): x(other.x) { ++copies; }
+	Counted(Counted &&other) noexcept: x(other.x) {}
+	Counted &operator=(const Counted &other) { x = other.x; ++copies; return *this; }
+	Counted &operator=(Counted &&other) noexcept { x = other.x; return *this; }
+};
+
+bool check5() { //inserting the sequence's own elements, and shifts, splits and merges that move rather than copy
+	sjtu::indexed_sequence<std::string, 8, 4> s;
+	std::deque<std::string> ref;
+	for (int i = 0; i < 10; ++i) s.push_back("s" + std::to_string(i)), ref.push_back("s" + std::to_string(i));
+	s.insert(s.begin() + 1, s[4]);
+	if (s[1] != "s4" || s[2] != "s1") return false;
+	ref.insert(ref.begin() + 1, std::string(ref[4]));
+	srand(45);
+	for (int i = 0; i < 5000; ++i) {
+		int k = rand() % (ref.size() + 1), j = rand() % ref.size();
+		s.insert(s.begin() + k, s[j]);
+		ref.insert(ref.begin() + k, std::string(ref[j]));
+		if (i % 3 == 0) s.push_front(s.back()), ref.push_front(std::string(ref.back()));
+	}
+	if (s.size() != ref.size() || !valid(s)) return false;
+	for (int i = 0; i < (int) ref.size(); ++i) if (s[i] != ref[i]) return false;
+	sjtu::indexed_sequence<Counted, 8, 4> c;
+	for (int i = 0; i < 10000; ++i) c.insert(c.begin() + rand() % (c.size() + 1), Counted(i));
+	while (c.size() > 10) c.erase(c.begin() + rand() % c.size());
+	return copies == 0;
+}
+
+int live = 0, budget = -1;
+
+struct Fragile { //counts live objects; copying throws once budget runs out
+	int x;
+	Fragile(int v = 0): x(v) { ++live; }
+	Fragile(const Fragile &other): x(other.x) {
+		if (budget == 0) throw sjtu::runtime_error();
+		if (budget > 0) --budget;
+		++live;
+	}
+	Fragile &operator=(const Fragile &other) { x = other.x; return *this; }
+	~Fragile() { --live; }
+};
+
+bool check6() { //a copy that throws partway through, in a single leaf or deep in the tree, leaks nothing
+	for (int n = 5; n <= 500; n += 495) {
+		sjtu::indexed_sequence<Fragile, 8, 4> s;
+		for (int i = 0; i < n; ++i) s.push_back(Fragile(i));
+		for (int b = 0; b < n; b += n / 5 + 1) {
+			budget = b;
+			try {
+				sjtu::indexed_sequence<Fragile, 8, 4> t(s);
+				budget = -1;
+				return false;
+			} catch (sjtu::runtime_error &) {}
+			budget = -1;
+			if (live != n) return false;
+		}
+	}
+	return live == 0;
+}
+
+int main() {
+	if (!check1()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check3()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	if (!check4()) std::cout << "Test 4 Failed......" << std::endl; else std::cout << "Test 4 Passed!" << std::endl;
+	if (!check5()) std::cout << "Test 5 Failed......" << std::endl; else std::cout << "Test 5 Passed!" << std::endl;
+	if (!check6()) std::cout << "Test 6 Failed......" << std::endl; else std::cout << "Test 6 Passed!" << std::endl;
+	return 0;
+}
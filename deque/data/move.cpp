@@ -0,0 +1,84 @@
+#include "deque1.hpp"
+#include "indexed_sequence.hpp"
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <cstdio>
+
+template<class D>
+D make(int n) {
+	D d;
+	for (int i = 0; i < n; ++i) {
+		if (i % 2) d.push_back(std::to_string(i));
+		else d.push_front(std::to_string(i));
+	}
+	return d;
+}
+
+template<class D>
+bool same(D &d, int n) { //the contents make<D>(n) built
+	if ((int) d.size() != n) return false;
+	for (int i = 0; i < n; ++i) {
+		int x = i < n / 2 ? 2 * (n / 2 - i) - (n % 2 ? 0 : 2) : 2 * (i - n / 2) + (n % 2 ? -1 : 1);
+		if (d[i] != std::to_string(x)) return false;
+	}
+	return true;
+}
+
+template<class D>
+bool moves() { //moved-to containers hold the elements, moved-from ones are empty and reusable, swap exchanges
+	D a = make<D>(10000);
+	D b(std::move(a));
+	if (!a.empty() || !same(b, 10000)) return false;
+	a.push_back("x");
+	a.push_front("y");
+	if (a.size() != 2 || a[0] != "y" || a[1] != "x") return false;
+	D c = make<D>(5);
+	c = std::move(b);
+	if (!b.empty() || !same(c, 10000)) return false;
+	swap(a, c);
+	if (!same(a, 10000) || c.size() != 2 || c.front() != "y") return false;
+	a.swap(a);
+	c = std::move(c);
+	b = make<D>(3);
+	b.insert(b.begin() + 1, "z");
+	b.erase(b.begin());
+	return same(a, 10000) && c.size() == 2 && b.size() == 3 && b[0] == "z";
+}
+
+bool check1() {
+	return moves<sjtu::deque<std::string, 16> >() && moves<sjtu::deque<std::string> >();
+}
+
+bool check2() {
+	return moves<sjtu::indexed_sequence<std::string, 8, 4> >() && moves<sjtu::indexed_sequence<std::string> >();
+}
+
+bool check3() { //a moved deque keeps its spare blocks and its directory, and does not share them
+	sjtu::deque<int, 16> a;
+	for (int i = 0; i < 1000; ++i) a.push_back(i);
+	for (int i = 0; i < 500; ++i) a.pop_back();
+	if (a[250] != 250) return false;
+	int spare = a.sparenum;
+	sjtu::deque<int, 16> b(std::move(a));
+	if (b.sparenum != spare || a.sparenum != 0 || a.spare != nullptr || a.dir != nullptr) return false;
+	for (int i = 0; i < 500; ++i) b.insert(b.begin() + i * 2, -i), a.push_back(i);
+	return b[0] == 0 && b[1] == 0 && b[2] == -1 && b[999] == 499 && a[499] == 499;
+}
+
+bool check4() { //pushing a copy of the front onto the front, which shifts the first block
+	sjtu::deque<std::string, 16> d;
+	for (int i = 0; i < 5; ++i) d.push_back("s" + std::to_string(i));
+	for (int i = 0; i < 40; ++i) d.push_front(d.front());
+	for (int i = 0; i < 41; ++i) if (d[i] != "s0") return false;
+	return d.size() == 45 && d[41] == "s1";
+}
+
+int main() {
+	if (!check1()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check3()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	if (!check4()) std::cout << "Test 4 Failed......" << std::endl; else std::cout << "Test 4 Passed!" << std::endl;
+	return 0;
+}
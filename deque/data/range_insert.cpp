@@ -0,0 +1,149 @@
+#include "deque1.hpp"
+
+#include <iostream>
+#include <deque>
+#include <vector>
+#include <string>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+
+template<class T, int B>
+bool balanced(const sjtu::deque<T, B> &d) { //every block between the first and the last is at least half full
+	typedef typename sjtu::deque<T, B>::block block;
+	int total = 0, count = 0;
+	for (block *p = d.head->next; p != d.tail; p = p->next, ++count) {
+		if (p->len <= 0 || p->len > p->size) return false;
+		if (p->last != d.head && p->next != d.tail && p->len < p->size / 2) return false;
+		total += p->len;
+	}
+	return total == (int) d.size() && count == d.blocknum;
+}
+
+bool check1() { //ranges of every length at every kind of position, against std::deque (whose empty inserts near the front are broken in libstdc++ 12)
+	sjtu::deque<std::string, 16> d;
+	std::deque<std::string> ref;
+	srand(49);
+	for (int i = 0; i < 20000; ++i) {
+		int op = rand() % 6, n = rand() % 4 ? rand() % 20 : rand() % 100;
+		std::vector<std::string> src;
+		for (int j = 0; j < n; ++j) src.push_back(std::to_string(rand()));
+		if (op == 0) {
+			d.append(src.begin(), src.end());
+			if (n > 0) ref.insert(ref.end(), src.begin(), src.end());
+		}
+		else if (op == 1) {
+			d.prepend(src.begin(), src.end());
+			if (n > 0) ref.insert(ref.begin(), src.begin(), src.end());
+		}
+		else if (op == 2) {
+			int k = rand() % (ref.size() + 1);
+			if (d.insert(d.begin() + k, src.begin(), src.end()) != d.begin() + k) return false;
+			if (n > 0) ref.insert(ref.begin() + k, src.begin(), src.end());
+		}
+		else if (op == 3) {
+			int k = rand() % (ref.size() + 1);
+			d.insert(d.begin() + k, n, std::to_string(i));
+			if (n > 0) ref.insert(ref.begin() + k, n, std::to_string(i));
+		}
+		else for (int j = 0; j < 3 * n && !ref.empty(); ++j) {
+			int k = rand() % ref.size();
+			d.erase(d.begin() + k);
+			ref.erase(ref.begin() + k);
+		}
+		if (i % 100 == 0) {
+			if (!balanced(d) || d.size() != ref.size()) return false;
+			for (int j = 0; j < (int) ref.size(); j += 7) if (d[j] != ref[j]) return false;
+		}
+		if (i % 5000 == 0) d.clear(), ref.clear();
+	}
+	if (!balanced(d) || d.size() != ref.size()) return false;
+	for (int j = 0; j < (int) ref.size(); ++j) if (d[j] != ref[j]) return false;
+	return true;
+}
+
+bool check2() { //other sources: pointers, another deque's iterators, an empty range, and n copies of a value
+	int a[1000];
+	for (int i = 0; i < 1000; ++i) a[i] = i;
+	sjtu::deque<int, 64> d, e;
+	d.append(a, a + 1000);
+	d.append(a, a);
+	e.insert(e.end(), 5, 7);
+	e.insert(e.begin() + 2, d.begin() + 10, d.begin() + 20);
+	d.prepend(e.begin(), e.end());
+	if (d.size() != 1015 || e.size() != 15 || !balanced(d)) return false;
+	for (int i = 0; i < 15; ++i) if (d[i] != (i >= 2 && i < 12 ? i + 8 : 7)) return false;
+	for (int i = 0; i < 1000; ++i) if (d[i + 15] != i) return false;
+	return true;
+}
+
+bool check3() { //appending 10k-element batches in bulk against element by element
+	const int N = 10000, R = 500;
+	std::vector<int> batch(N);
+	for (int i = 0; i < N; ++i) batch[i] = i;
+	sjtu::deque<int> a, b;
+	clock_t t = clock();
+	for (int r = 0; r < R; ++r) for (int i = 0; i < N; ++i) a.push_back(batch[i]);
+	double one = (double) (clock() - t) / CLOCKS_PER_SEC;
+	t = clock();
+	for (int r = 0; r < R; ++r) b.append(batch.begin(), batch.end());
+	double bulk = (double) (clock() - t) / CLOCKS_PER_SEC;
+	t = clock();
+	for (int r = 0; r < 200; ++r) b.insert(b.begin() + rand() % (int) b.size(), batch.begin(), batch.end());
+	printf("%d batches of %d: push_back %.3fs, append %.3fs; 200 middle batch inserts %.3fs ", R, N, one, bulk, (double) (clock() - t) / CLOCKS_PER_SEC);
+	return a.size() == (size_t) N * R && b.size() == (size_t) N * (R + 200) && a[N * R - 1] == N - 1 && balanced(b);
+}
+
+int budget = -1, alive = 0;
+
+struct Fragile { //its copies throw once the budget runs out; counts live objects
+	std::string s;
+	Fragile(const std::string &v = ""): s(v) { ++alive; }
+	Fragile(const Fragile &other): s(other.s) {
+		if (budget == 0) throw 0;
+		if (budget > 0) --budget;
+		++alive;
+	}
+	Fragile(Fragile &&other) noexcept: s(std::move(other.s)) { ++alive; }
+	Fragile &operator=(const Fragile &other) {
+		if (budget == 0) throw 0;
+		if (budget > 0) --budget;
+		s = other.s;
+		return *this;
+	}
+	Fragile &operator=(Fragile &&other) noexcept { s = std::move(other.s); return *this; }
+	~Fragile() { --alive; }
+};
+
+bool check4() { //n copies of one of the deque's own elements, and a copy that throws halfway through a batch
+	sjtu::deque<std::string, 16> e;
+	e.push_back("a");
+	e.push_back("b");
+	e.insert(e.begin() + 1, 3, e[1]);
+	if (e.size() != 5 || e[0] != "a" || e[1] != "b" || e[3] != "b" || e[4] != "b") return false;
+	{
+		sjtu::deque<Fragile, 16> d;
+		std::vector<Fragile> src;
+		for (int i = 0; i < 100; ++i) d.push_back(Fragile(std::to_string(i)));
+		for (int i = 0; i < 60; ++i) src.push_back(Fragile("x"));
+		for (int k = 0; k <= 100; k += 5) for (int b = 0; b < 60; b += 7) {
+			budget = b;
+			try {
+				d.insert(d.begin() + k, src.begin(), src.end());
+				return false;
+			} catch (int) {}
+			budget = -1;
+			if (d.size() != 100 || !balanced(d) || alive != 160) return false;
+			for (int i = 0; i < 100; ++i) if (d[i].s != std::to_string(i)) return false;
+		}
+	}
+	return alive == 0;
+}
+
+int main() {
+	if (!check1()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check3()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	if (!check4()) std::cout << "Test 4 Failed......" << std::endl; else std::cout << "Test 4 Passed!" << std::endl;
+	return 0;
+}
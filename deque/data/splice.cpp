@@ -0,0 +1,142 @@
+#include "deque1.hpp"
+
+#include <iostream>
+#include <deque>
+#include <string>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+
+template<class T, int B>
+bool balanced(const sjtu::deque<T, B> &d) { //every block between the first and the last is at least half full
+	typedef typename sjtu::deque<T, B>::block block;
+	int total = 0, count = 0;
+	for (block *p = d.head->next; p != d.tail; p = p->next, ++count) {
+		if (p->len <= 0 || p->len > p->size) return false;
+		if (p->last != d.head && p->next != d.tail && p->len < p->size / 2) return false;
+		total += p->len;
+	}
+	return total == (int) d.size() && count == d.blocknum;
+}
+
+template<class T, int B>
+bool same(const sjtu::deque<T, B> &d, const std::deque<T> &ref) {
+	if (!balanced(d) || d.size() != ref.size()) return false;
+	for (int i = 0; i < (int) ref.size(); ++i) if (d[i] != ref[i]) return false;
+	return true;
+}
+
+bool check1() { //a few deques cut and glued back together at random, against std::deque
+	const int K = 4;
+	sjtu::deque<std::string, 16> d[K];
+	std::deque<std::string> ref[K];
+	srand(50);
+	for (int i = 0; i < 20000; ++i) {
+		int a = rand() % K, b = rand() % K, op = rand() % 5;
+		if (op == 0) {
+			int n = rand() % 40;
+			for (int j = 0; j < n; ++j) {
+				std::string s = std::to_string(rand());
+				int k = rand() % 2 ? ref[a].size() : rand() % (ref[a].size() + 1);
+				d[a].insert(d[a].begin() + k, s);
+				ref[a].insert(ref[a].begin() + k, s);
+			}
+		}
+		else if (op == 1 && a != b) {
+			d[a].splice_back(std::move(d[b]));
+			ref[a].insert(ref[a].end(), ref[b].begin(), ref[b].end());
+			ref[b].clear();
+		}
+		else if (op == 2 && a != b) {
+			d[a].splice_front(std::move(d[b]));
+			ref[b].insert(ref[b].end(), ref[a].begin(), ref[a].end());
+			ref[a].swap(ref[b]);
+			ref[b].clear();
+		}
+		else if (op == 3 && a != b) {
+			int k = rand() % (ref[a].size() + 1);
+			d[b].splice_back(d[a].split_at(d[a].begin() + k));
+			ref[b].insert(ref[b].end(), ref[a].begin() + k, ref[a].end());
+			ref[a].erase(ref[a].begin() + k, ref[a].end());
+		}
+		else if (!ref[a].empty()) {
+			int n = rand() % (ref[a].size() + 1);
+			for (int j = 0; j < n; ++j) {
+				int k = rand() % ref[a].size();
+				d[a].erase(d[a].begin() + k);
+				ref[a].erase(ref[a].begin() + k);
+			}
+		}
+		if (i % 50 == 0) for (int j = 0; j < K; ++j) if (!same(d[j], ref[j])) return false;
+	}
+	for (int j = 0; j < K; ++j) if (!same(d[j], ref[j])) return false;
+	return true;
+}
+
+bool check2() { //the edges: empty sides, cuts at both ends, self-splices, and reusing a drained deque
+	sjtu::deque<int, 16> a, b;
+	std::deque<int> ra, rb;
+	a.splice_back(std::move(b));
+	a.splice_front(std::move(b));
+	if (!a.empty() || a.blocknum != 0) return false;
+	for (int i = 0; i < 100; ++i) a.push_back(i), ra.push_back(i);
+	a.splice_back(std::move(a));
+	a.splice_front(std::move(a));
+	if (!same(a, ra)) return false;
+	b.splice_back(std::move(a)); //into an empty deque
+	if (!a.empty() || a.blocknum != 0 || !same(b, ra)) return false;
+	for (int i = 0; i < 10; ++i) a.push_back(-i), rb.push_back(-i);
+	if (!same(a, rb)) return false;
+	sjtu::deque<int, 16> c = b.split_at(b.end());
+	if (!c.empty() || !same(b, ra)) return false;
+	c = b.split_at(b.begin());
+	if (!b.empty() || b.blocknum != 0 || !same(c, ra)) return false;
+	b = c.split_at(c.begin() + 37);
+	if (c.size() != 37 || b.size() != 63 || c.back() != 36 || b.front() != 37 || !balanced(b) || !balanced(c)) return false;
+	c.push_back(37); //the directory of the cut deque is still right
+	if (c[37] != 37 || c.at(20) != 20) return false;
+	c.pop_back();
+	c.splice_back(std::move(b));
+	if (!same(c, ra)) return false;
+	c.splice_front(std::move(a));
+	rb.insert(rb.end(), ra.begin(), ra.end());
+	if (!same(c, rb)) return false;
+	try {
+		c.split_at(a.begin());
+		return false;
+	} catch (sjtu::invalid_iterator &) {}
+	try {
+		c.split_at(c.end() + 1);
+		return false;
+	} catch (sjtu::index_out_of_bound &) {}
+	return same(c, rb);
+}
+
+bool check3() { //handing 1M elements between stages in halves, against popping and pushing them
+	const int N = 1000000, R = 2;
+	sjtu::deque<int> a, b;
+	for (int i = 0; i < N; ++i) a.push_back(i);
+	clock_t t = clock();
+	for (int r = 0; r < R; ++r) {
+		while (!a.empty()) b.push_back(a.front()), a.pop_front();
+		a.swap(b);
+	}
+	double one = (double) (clock() - t) / CLOCKS_PER_SEC;
+	t = clock();
+	for (int r = 0; r < R; ++r) {
+		b.splice_back(a.split_at(a.begin() + N / 2));
+		b.splice_front(std::move(a));
+		a.swap(b);
+	}
+	printf("%d hand-offs of %d: element by element %.3fs, split and splice %.3fs ", R, N, one, (double) (clock() - t) / CLOCKS_PER_SEC);
+	bool ok = a.size() == (size_t) N && b.empty() && balanced(a);
+	for (int i = 0; i < N; i += 999) ok = ok && a[i] == i;
+	return ok;
+}
+
+int main() {
+	if (!check1()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check3()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	return 0;
+}
@@ -5,19 +5,35 @@
 
 #include <cstddef>
 #include <cassert>
+#include <cstring>
+#include <type_traits>
+#include <utility>
 
 namespace sjtu {
 
+    /**
+     * the default number of elements in a deque block: as many as fit in BYTES, but at least 16
+     */
     template<class T>
+    struct deque_block {
+        static const int BYTES = 4096;
+        static const int value = BYTES / sizeof(T) > 16 ? BYTES / sizeof(T) : 16;
+    };
+
+    template<class T, int BlockSize = deque_block<T>::value>
     class deque {
     public:
         struct block {
             block *last, *next;
             T *data;
-            int size, len;
-            block(): size(1024), len(0), last(nullptr), next(nullptr) {
+            int size, len, id;
+            block(): size(BlockSize), len(0), last(nullptr), next(nullptr) {
                 data = (T*) (operator new (size * sizeof(T)));
             }
+            /**
+             * a sentinel: links only, no storage
+             */
+            block(std::nullptr_t): last(nullptr), next(nullptr), data(nullptr), size(0), len(0) {}
             block(const block &other): size(other.size), len(other.len), last(nullptr), next(nullptr) {
                 data = (T*) (operator new (size * sizeof(T)));
                 for (int i = 0; i < len; ++i) {
@@ -25,14 +41,217 @@ namespace sjtu {
                 }
             }
             ~block() {
+                reset();
+                operator delete (data);
+            }
+            void reset() {
                 for (int i = 0; i < len; ++i)
                     data[i].~T();
-                operator delete (data);
                 len = 0;
+                last = next = nullptr;
             }
         };
+        /**
+         * Emptied blocks are kept for reuse, up to peak, the most the deque has had in use lately, or
+         * SPARE_LIMIT if that is more, so a deque that shrinks and grows back does not go to the allocator
+         * again. Every 2 * peak + SPARE_LIMIT blocks taken or given back, peak drops to the most that were
+         * in use during that stretch (high) and the spares beyond it are freed, so the memory of a deque
+         * that has shrunk for good goes back once it is used a little; shrink_to_fit frees it at once.
+         */
+        static const int SPARE_LIMIT = 64;
+        /**
+         * the sentinels live inside the deque, so an empty deque owns no memory at all
+         */
+        block head_node, tail_node;
         block *head, *tail;
-        int length, blocknum;
+        block *spare;
+        int length, blocknum, sparenum, peak, high, ticks;
+        /**
+         * The directory lists the blocks in order with their lengths, and tree is a Fenwick tree over
+         * those lengths, so a position is found in O(log blocknum). Length changes update it in place,
+         * and so does adding or removing a block at the back; a block added or removed in the middle
+         * shifts the flat arrays and rebuilds the tree from them in one linear pass. A change at the
+         * front only marks the directory dirty, and the next lookup rebuilds it from the list.
+         */
+        mutable block **dir;
+        mutable int *lens, *tree;
+        mutable int dircap, dirnum, dirtop;
+        mutable bool dirty;
+        void reserve_dir(int cap) const {
+            if (dircap >= cap) return;
+            int newcap = cap > dircap * 2 ? cap : dircap * 2;
+            block **d = new block*[newcap];
+            int *l = new int[newcap], *t = new int[newcap + 1];
+            for (int i = 0; i < dirnum; ++i) {
+                d[i] = dir[i];
+                l[i] = lens[i];
+                t[i + 1] = tree[i + 1];
+            }
+            delete [] dir;
+            delete [] lens;
+            delete [] tree;
+            dir = d;
+            lens = l;
+            tree = t;
+            dircap = newcap;
+        }
+        void build_tree() const {
+            for (int i = 1; i <= dirnum; ++i)
+                tree[i] = lens[i - 1];
+            for (int i = 1; i <= dirnum; ++i)
+                if (i + (i & -i) <= dirnum) tree[i + (i & -i)] += tree[i];
+            for (dirtop = 1; dirtop * 2 <= dirnum; dirtop *= 2);
+        }
+        void rebuild() const {
+            reserve_dir(blocknum);
+            dirnum = 0;
+            for (block *p = head->next; p != tail; p = p->next, ++dirnum) {
+                dir[dirnum] = p;
+                p->id = dirnum;
+                lens[dirnum] = p->len;
+            }
+            build_tree();
+            dirty = false;
+        }
+        /**
+         * the total length of the first n blocks
+         */
+        int prefix(int n) const {
+            int ret = 0;
+            for (; n > 0; n -= n & -n)
+                ret += tree[n];
+            return ret;
+        }
+        /**
+         * record that the length of p changed by delta
+         */
+        void resize(block *p, int delta) {
+            if (dirty) return;
+            lens[p->id] += delta;
+            for (int i = p->id + 1; i <= dirnum; i += i & -i)
+                tree[i] += delta;
+        }
+        /**
+         * p has just been linked into the list
+         */
+        void dir_insert(block *p) {
+            if (dirty) return;
+            int k = p->last == head ? 0 : p->last->id + 1;
+            if (k == 0 && dirnum > 0) {
+                dirty = true;
+                return;
+            }
+            reserve_dir(dirnum + 1);
+            for (int i = dirnum; i > k; --i) {
+                dir[i] = dir[i - 1];
+                lens[i] = lens[i - 1];
+                dir[i]->id = i;
+            }
+            dir[k] = p;
+            p->id = k;
+            lens[k] = p->len;
+            ++dirnum;
+            if (k + 1 < dirnum) build_tree();
+            else {
+                tree[dirnum] = p->len + prefix(dirnum - 1) - prefix(dirnum - (dirnum & -dirnum));
+                for (dirtop = 1; dirtop * 2 <= dirnum; dirtop *= 2);
+            }
+        }
+        /**
+         * p is about to be unlinked from the list
+         */
+        void dir_erase(block *p) {
+            if (dirty) return;
+            int k = p->id;
+            if (k == 0 && dirnum > 1) {
+                dirty = true;
+                return;
+            }
+            --dirnum;
+            for (int i = k; i < dirnum; ++i) {
+                dir[i] = dir[i + 1];
+                lens[i] = lens[i + 1];
+                dir[i]->id = i;
+            }
+            if (k < dirnum) build_tree();
+            else for (dirtop = 1; dirtop * 2 <= dirnum; dirtop *= 2);
+        }
+        void release_dir() {
+            delete [] dir;
+            delete [] lens;
+            delete [] tree;
+            dir = nullptr;
+            lens = tree = nullptr;
+            dircap = dirnum = 0;
+            dirty = true;
+        }
+        /**
+         * n blocks are in use
+         */
+        void note_use(int n) {
+            if (n > peak) peak = n;
+            if (n > high) high = n;
+        }
+        void tick() {
+            if (++ticks < 2 * peak + SPARE_LIMIT) return;
+            peak = high;
+            high = blocknum;
+            ticks = 0;
+            while (sparenum > SPARE_LIMIT && sparenum > peak) {
+                block *p = spare;
+                spare = spare->next;
+                delete p;
+                --sparenum;
+            }
+        }
+        block *get_block() {
+            note_use(blocknum + 1);
+            tick();
+            if (spare == nullptr) return new block;
+            block *p = spare;
+            spare = spare->next;
+            p->next = nullptr;
+            --sparenum;
+            return p;
+        }
+        void put_block(block *p) {
+            p->reset();
+            tick();
+            if (sparenum >= SPARE_LIMIT && sparenum >= peak) {
+                delete p;
+                return;
+            }
+            p->next = spare;
+            spare = p;
+            ++sparenum;
+        }
+        /**
+         * copy n elements from src onto the end of p, with one memcpy when T allows it
+         */
+        static void fill(block *p, const T *src, int n, std::true_type) {
+            memcpy((void*) (p->data + p->len), (const void*) src, n * sizeof(T));
+            p->len += n;
+        }
+        static void fill(block *p, const T *src, int n, std::false_type) {
+            for (int i = 0; i < n; ++i, ++p->len)
+                new(p->data + p->len) T(src[i]);
+        }
+        /**
+         * append a copy of other, packed into full blocks whatever the shape of other's blocks;
+         * the blocks come from the spare list first, so an assignment reuses the ones clear() let go
+         */
+        void append_copy(const deque &other) {
+            dirty = true;
+            block *p = tail->last;
+            for (block *q = other.head->next; q != other.tail; q = q->next)
+                for (int i = 0; i < q->len; ) {
+                    if (p == head || p->len == p->size) p = add_block(p);
+                    int n = q->len - i < p->size - p->len ? q->len - i : p->size - p->len;
+                    fill(p, q->data + i, n, std::is_trivially_copyable<T>());
+                    length += n;
+                    i += n;
+                }
+        }
         class const_iterator;
         class iterator {
         private:
@@ -82,33 +301,13 @@ namespace sjtu {
             }
             T& operator*() const {
                 if (pos >= it->length + 1 || pos <= 0) throw index_out_of_bound();
-                int count = 0, ret = 0;
-                block *p = it->head->next;
-                while (count < pos) {
-                    if (count + p->len < pos) {
-                        count += p->len;
-                        p = p->next;
-                    }
-                    else {
-                        ret = pos - count - 1;
-                        return p->data[ret];
-                    }
-                }
+                int n;
+                block *p;
+                it->findPos(pos, n, p);
+                return p->data[n - 1];
             }
             T* operator->() const noexcept {
-                if (pos >= it->length + 1 || pos <= 0) throw index_out_of_bound();
-                int count = 0, ret = 0;
-                block *p = it->head->next;
-                while (count < pos) {
-                    if (count + p->len < pos) {
-                        count += p->len;
-                        p = p->next;
-                    }
-                    else {
-                        ret = pos - count - 1;
-                        return &p->data[ret];
-                    }
-                }
+                return &**this;
             }
             bool operator==(const iterator &rhs) const {
                 if (rhs.pos == pos && rhs.it == it) return true;
@@ -183,33 +382,13 @@ namespace sjtu {
             }
             const T& operator*() const {
                 if (pos >= it->length + 1 || pos <= 0) throw index_out_of_bound();
-                int count = 0, ret = 0;
-                block *p = it->head->next;
-                while (count < pos) {
-                    if (count + p->len < pos) {
-                        count += p->len;
-                        p = p->next;
-                    }
-                    else {
-                        ret = pos - count;
-                        return p->data[ret - 1];
-                    }
-                }
+                int n;
+                block *p;
+                it->findPos(pos, n, p);
+                return p->data[n - 1];
             }
             const T* operator->() const noexcept {
-                if (pos >= it->length + 1 || pos <= 0) throw index_out_of_bound();
-                int count = 0, ret = 0;
-                block *p = it->head->next;
-                while (count < pos) {
-                    if (count + p->len < pos) {
-                        count += p->len;
-                        p = p->next;
-                    }
-                    else {
-                        ret = pos - count;
-                        return &p->data[ret - 1];
-                    }
-                }
+                return &**this;
             }
             bool operator==(const iterator &rhs) const {
                 if (rhs.pos == pos && rhs.it == it) return true;
@@ -228,85 +407,127 @@ namespace sjtu {
                 else return true;
             }
         };
-        deque() {
+        deque(): head_node(nullptr), tail_node(nullptr) {
             length = 0;
             blocknum = 0;
-            head = new block;
-            tail = new block;
+            spare = nullptr;
+            sparenum = peak = high = ticks = 0;
+            head = &head_node;
+            tail = &tail_node;
+            dir = nullptr;
+            lens = tree = nullptr;
+            dircap = dirnum = 0;
+            dirty = true;
             head->next = tail;
             tail->last = head;
         }
-        deque(const deque &other) {
-	        length = other.length;
-	        blocknum = other.blocknum;
-            if (length == 0) {
-                head = new block;
-                tail = new block;
-                head->next = tail;
-                tail->last = head;
-            }
-            else {
-                head = new block;
-                block *p = head, *q = other.head->next;
-                while (q != other.tail) {
-                    block *tmp;
-                    tmp = new block(*q);
-                    tmp->last = p;
-                    p->next = tmp;
-                    p = p->next;
-                    q = q->next;
-                }
-                tail = new block;
-                tail->last = p;
-                p->next = tail;
+        deque(const deque &other): head_node(nullptr), tail_node(nullptr) {
+            length = 0;
+            blocknum = 0;
+            spare = nullptr;
+            sparenum = peak = high = ticks = 0;
+            head = &head_node;
+            tail = &tail_node;
+            dir = nullptr;
+            lens = tree = nullptr;
+            dircap = dirnum = 0;
+            dirty = true;
+            head->next = tail;
+            tail->last = head;
+            try {
+                append_copy(other);
+            } catch (...) {
+                clear();
+                shrink_to_fit();
+                throw;
             }
         }
+        /**
+         * the blocks, spares and directory of other become this deque's; other is left empty
+         */
+        deque(deque &&other) noexcept: head_node(nullptr), tail_node(nullptr) {
+            head = &head_node;
+            tail = &tail_node;
+            steal(other);
+        }
         ~deque() {
             clear();
-            delete head;
-            delete tail;
+            shrink_to_fit();
         }
-        deque &operator=(const deque &other) {
-            if (this == &other) return *this;
-            clear();
+        /**
+         * take everything other owns; this deque must own nothing
+         */
+        void steal(deque &other) noexcept {
             length = other.length;
             blocknum = other.blocknum;
-            if (length == 0) {
+            spare = other.spare;
+            sparenum = other.sparenum;
+            peak = other.peak;
+            high = other.high;
+            ticks = other.ticks;
+            dir = other.dir;
+            lens = other.lens;
+            tree = other.tree;
+            dircap = other.dircap;
+            dirnum = other.dirnum;
+            dirtop = other.dirtop;
+            dirty = other.dirty;
+            // only the first and last blocks point at the sentinels, which stay with their deque
+            if (other.head->next == other.tail) {
                 head->next = tail;
                 tail->last = head;
             }
             else {
-                block *p = head, *q = other.head->next;
-                while (q != other.tail) {
-                    block *tmp;
-                    tmp = new block(*q);
-                    tmp->last = p;
-                    p->next = tmp;
-                    p = p->next;
-                    q = q->next;
-                }
-                tail->last = p;
-                p->next = tail;
+                head->next = other.head->next;
+                head->next->last = head;
+                tail->last = other.tail->last;
+                tail->last->next = tail;
             }
+            other.head->next = other.tail;
+            other.tail->last = other.head;
+            other.length = other.blocknum = other.sparenum = other.peak = other.high = other.ticks = 0;
+            other.spare = nullptr;
+            other.dir = nullptr;
+            other.lens = other.tree = nullptr;
+            other.dircap = other.dirnum = 0;
+            other.dirty = true;
+        }
+        deque &operator=(deque &&other) noexcept {
+            if (this == &other) return *this;
+            clear();
+            shrink_to_fit();
+            steal(other);
             return *this;
         }
+        void swap(deque &other) noexcept {
+            if (this == &other) return;
+            deque tmp(std::move(other));
+            other.steal(*this);
+            steal(tmp);
+        }
+        deque &operator=(const deque &other) {
+            if (this == &other) return *this;
+            clear();
+            append_copy(other);
+            return *this;
+        }
+        /**
+         * the block p holding the start-th element (from 1) and its place pos (from 1) in it
+         */
         void findPos(int start, int &pos, block *&p) const{
-            int count = 0;
-            p = head->next;
-            while (count < start) {
-                if (count + p->len < start) {
-                    count += p->len;
-                    p = p->next;
-                }
-                else {
-                    pos = start - count;
-                    return;
+            if (dirty) rebuild();
+            int i = 0;
+            for (int step = dirtop; step > 0; step >>= 1)
+                if (i + step <= dirnum && tree[i + step] < start) {
+                    i += step;
+                    start -= tree[i];
                 }
-            }
+            p = dir[i];
+            pos = start;
         }
         void split(block *p, int pos) {
             block *tmp;
-            tmp = new block;
+            tmp = get_block();
             block *nextp = p->next;
             tmp->next = nextp;
             nextp->last = tmp;
@@ -314,83 +535,132 @@ namespace sjtu {
             tmp->last = p;
             int i;
             for (i = pos; i < p->len; ++i)
-                new(tmp->data + i -pos) T(p->data[i]);
+                new(tmp->data + i -pos) T(std::move(p->data[i]));
             for (int j = pos; j < p->len; ++j)
                 p->data[j].~T();
             tmp->len = i - pos;
+            resize(p, pos - p->len);
             p->len = pos;
             ++blocknum;
+            dir_insert(tmp);
         }
         void merge(block *p) {
             block *nextp = p->next;
             if (p->len + nextp->len <= p->size && nextp != tail && p != head) {
                 for (int pos = 0; pos < nextp->len; ++pos, ++p->len)
-                    new(p->data + p->len) T(nextp->data[pos]);
+                    new(p->data + p->len) T(std::move(nextp->data[pos]));
+                resize(p, nextp->len);
+                dir_erase(nextp);
                 p->next = nextp->next;
                 nextp->next->last = p;
-                delete nextp;
+                put_block(nextp);
                 --blocknum;
             }
         }
-        T & at(const size_t &pos) {
-            if (pos < 0 || pos >= length) throw index_out_of_bound();
-            int count = 0, ret = 0, start = pos + 1;
-            block *p = head->next;
-            while (count < start) {
-                if (count + p->len < start) {
-                    count += p->len;
-                    p = p->next;
-                }
-                else {
-                    ret = start - count;
-                    return p->data[ret - 1];
-                }
+        /**
+         * link a new empty block in after p
+         */
+        block *add_block(block *p) {
+            block *tmp = get_block();
+            tmp->next = p->next;
+            p->next->last = tmp;
+            p->next = tmp;
+            tmp->last = p;
+            ++blocknum;
+            dir_insert(tmp);
+            return tmp;
+        }
+        /**
+         * put value at index i of a block that has room, shifting the rest of the block right
+         */
+        template<class U>
+        void insert_at(block *p, int i, U &&value) {
+            if (i == p->len) new(p->data + i) T(std::forward<U>(value));
+            else {
+                new(p->data + p->len) T(std::move(p->data[p->len - 1]));
+                for (int j = p->len - 1; j > i; --j)
+                    p->data[j] = std::move(p->data[j - 1]);
+                p->data[i] = std::forward<U>(value);
             }
+            ++p->len;
+            resize(p, 1);
         }
-        const T & at(const size_t &pos) const {
-            if (pos < 0 || pos >= length) throw index_out_of_bound();
-            int count = 0, ret = 0, start = pos + 1;
-            block *p = head->next;
-            while (count < start) {
-                if (count + p->len < start) {
-                    count += p->len;
-                    p = p->next;
-                }
-                else {
-                    ret = start - count;
-                    return p->data[ret - 1];
-                }
+        void erase_at(block *p, int i) {
+            for (int j = i; j < p->len - 1; ++j)
+                p->data[j] = std::move(p->data[j + 1]);
+            --p->len;
+            p->data[p->len].~T();
+            resize(p, -1);
+        }
+        /**
+         * move the first k elements of the next block onto the end of p
+         */
+        void borrow(block *p, int k) {
+            block *q = p->next;
+            for (int j = 0; j < k; ++j, ++p->len)
+                new(p->data + p->len) T(std::move(q->data[j]));
+            for (int j = k; j < q->len; ++j)
+                q->data[j - k] = std::move(q->data[j]);
+            for (int j = q->len - k; j < q->len; ++j)
+                q->data[j].~T();
+            q->len -= k;
+            resize(p, k);
+            resize(q, -k);
+        }
+        /**
+         * Every block but the first and the last holds between size / 2 and size elements, so a middle
+         * insert or erase moves O(size) elements. When p has fallen under half, merge it with a neighbour
+         * if the two fit in one block, or else borrow up to half from the next block, which then has to spare.
+         */
+        void fix(block *p) {
+            if (p->len == 0) {
+                drop_empty(p);
+                return;
             }
+            if (p->len >= p->size / 2 || p->last == head || p->next == tail) return;
+            block *q = p->next;
+            if (p->len + q->len <= p->size) merge(p);
+            else if (p->last->len + p->len <= p->size) merge(p->last);
+            else borrow(p, p->size / 2 - p->len);
+        }
+        /**
+         * unlink p and recycle it if it has been emptied
+         */
+        void drop_empty(block *p) {
+            if (p->len != 0 || p == head || p == tail) return;
+            dir_erase(p);
+            p->last->next = p->next;
+            p->next->last = p->last;
+            put_block(p);
+            --blocknum;
+        }
+        T & at(const size_t &pos) {
+            if (pos >= (size_t) length) throw index_out_of_bound();
+            int n;
+            block *p;
+            findPos(pos + 1, n, p);
+            return p->data[n - 1];
+        }
+        const T & at(const size_t &pos) const {
+            if (pos >= (size_t) length) throw index_out_of_bound();
+            int n;
+            block *p;
+            findPos(pos + 1, n, p);
+            return p->data[n - 1];
         }
         T & operator[](const size_t &pos) {
-            if (pos < 0 || pos >= length) throw index_out_of_bound();
-            int count = 0, ret = 0, start = pos + 1;
-            block *p = head->next;
-            while (count < start) {
-                if (count + p->len < start) {
-                    count += p->len;
-                    p = p->next;
-                }
-                else {
-                    ret = start - count;
-                    return p->data[ret - 1];
-                }
-            }
+            if (pos >= (size_t) length) throw index_out_of_bound();
+            int n;
+            block *p;
+            findPos(pos + 1, n, p);
+            return p->data[n - 1];
         }
         const T & operator[](const size_t &pos) const {
-            if (pos < 0 || pos >= length) throw index_out_of_bound();
-            int count = 0, ret = 0, start = pos + 1;
-            block *p = head->next;
-            while (count < start) {
-                if (count + p->len < start) {
-                    count += p->len;
-                    p = p->next;
-                }
-                else {
-                    ret = start - count;
-                    return p->data[ret - 1];
-                }
-            }
+            if (pos >= (size_t) length) throw index_out_of_bound();
+            int n;
+            block *p;
+            findPos(pos + 1, n, p);
+            return p->data[n - 1];
         }
         const T & front() const {
             if (length == 0) throw container_is_empty();
@@ -421,23 +691,37 @@ namespace sjtu {
         size_t size() const {
             return length;
         }
+        /**
+         * the blocks go to the spare list back to front, so a refill takes them again in their old order
+         */
         void clear() {
-            block *p = head->next;
+            block *p = tail->last;
             block *q = p;
-            while (p != tail) {
-                p = p->next;
-                delete q;
+            while (p != head) {
+                p = p->last;
+                put_block(q);
                 q = p;
             }
             length = 0;
             blocknum = 0;
-            delete head;
-            delete tail;
-            head = new block;
-            tail = new block;
+            dirty = true;
             head->next = tail;
             tail->last = head;
         }
+        /**
+         * give the spare blocks and the block directory back to the allocator
+         */
+        void shrink_to_fit() {
+            while (spare != nullptr) {
+                block *p = spare;
+                spare = spare->next;
+                delete p;
+            }
+            sparenum = 0;
+            peak = high = blocknum;
+            ticks = 0;
+            release_dir();
+        }
         iterator insert(iterator pos, const T &value) {
             int start = pos.pos, n;
             if (pos.it != this) throw invalid_iterator();
@@ -451,86 +735,318 @@ namespace sjtu {
             }
             else {
                 if (start <= 0 || start > length + 1) throw index_out_of_bound();
+                // value may be an element of this deque, which the split and the shift below move
+                T copy(value);
                 block *p;
                 findPos(start, n, p);
-                split(p, n - 1);
-                block *tmp;
-                tmp = new block;
-                ++blocknum;
-                block *nextp = p->next;
-                tmp->next = nextp;
-                nextp->last = tmp;
-                tmp->last = p;
-                p->next = tmp;
-                new(tmp->data) T(value);
+                --n;
+                if (p->len == p->size) {
+                    split(p, p->size / 2);
+                    if (n > p->len) {
+                        n -= p->len;
+                        p = p->next;
+                    }
+                }
+                insert_at(p, n, std::move(copy));
                 ++length;
-                ++tmp->len;
-                merge(tmp);
-                merge(p);
                 return iterator(start, this);
             }
         }
+        /**
+         * the source of insert(pos, n, value): the same element n times
+         */
+        struct repeat {
+            const T *value;
+            const T &operator*() const {
+                return *value;
+            }
+            repeat &operator++() {
+                return *this;
+            }
+        };
+        /**
+         * Put n elements from first before the start-th element (from 1). The block holding that element
+         * is split there once: the elements after the split point and then the new ones are written
+         * straight into their final places, filling the rest of that block and as many new blocks as
+         * needed, all taken before anything moves. Only the last of these can end up under half full.
+         * If taking a block or copying an element throws, the deque is put back as it was.
+         */
+        template<class It>
+        void insert_range(int start, It first, int n) {
+            if (n <= 0) return;
+            block *p;
+            int i;
+            if (length == 0) {
+                p = add_block(head);
+                i = 0;
+            }
+            else if (start == length + 1) {
+                p = tail->last;
+                i = p->len;
+            }
+            else {
+                findPos(start, i, p);
+                --i;
+            }
+            int size = p->size, oldlen = p->len, total = i + n + (oldlen - i);
+            int m = (total + size - 1) / size;
+            dirty = true;
+            block *last = p;
+            try {
+                for (int b = 1; b < m; ++b)
+                    last = add_block(last);
+            } catch (...) {
+                while (last != p) {
+                    block *q = last->last;
+                    drop_empty(last);
+                    last = q;
+                }
+                drop_empty(p);
+                throw;
+            }
+            // the elements after the split point go to the end, back to front since they may overlap in p
+            block *cur = last;
+            int cidx = m - 1;
+            for (int x = total - 1; x >= i + n; --x) {
+                while (x / size < cidx) {
+                    cur = cur->last;
+                    --cidx;
+                }
+                if (cur == p && x % size < oldlen) p->data[x % size] = std::move(p->data[x - n]);
+                else new(cur->data + x % size) T(std::move(p->data[x - n]));
+            }
+            cur = p;
+            cidx = 0;
+            int x = i;
+            try {
+                for (; x < i + n; ++x, ++first) {
+                    while (x / size > cidx) {
+                        cur = cur->next;
+                        ++cidx;
+                    }
+                    if (cur == p && x < oldlen) p->data[x] = *first;
+                    else new(cur->data + x % size) T(*first);
+                }
+            } catch (...) {
+                // a copy threw: move the displaced elements back and destroy everything past the old end of p
+                for (int y = i; y < oldlen; ++y) {
+                    while ((y + n) / size > cidx) {
+                        cur = cur->next;
+                        ++cidx;
+                    }
+                    while ((y + n) / size < cidx) {
+                        cur = cur->last;
+                        --cidx;
+                    }
+                    p->data[y] = std::move(cur->data[(y + n) % size]);
+                }
+                cur = p;
+                cidx = 0;
+                for (int y = oldlen; y < total; ++y) {
+                    while (y / size > cidx) {
+                        cur = cur->next;
+                        ++cidx;
+                    }
+                    if (y < x || y >= i + n) cur->data[y % size].~T();
+                }
+                while (last != p) {
+                    block *q = last->last;
+                    drop_empty(last);
+                    last = q;
+                }
+                drop_empty(p);
+                throw;
+            }
+            p->len = total < size ? total : size;
+            for (cur = p->next, cidx = 1; cidx < m; cur = cur->next, ++cidx)
+                cur->len = cidx < m - 1 ? size : total - (m - 1) * size;
+            length += n;
+            fix(last);
+        }
+        /**
+         * insert [first, last) before pos; It needs to be a forward iterator, as the range is counted first
+         */
+        template<class It, class = typename std::enable_if<!std::is_integral<It>::value>::type>
+        iterator insert(iterator pos, It first, It last) {
+            if (pos.it != this) throw invalid_iterator();
+            if (pos.pos <= 0 || pos.pos > length + 1) throw index_out_of_bound();
+            int n = 0;
+            for (It it = first; it != last; ++it) ++n;
+            insert_range(pos.pos, first, n);
+            return pos;
+        }
+        iterator insert(iterator pos, size_t n, const T &value) {
+            if (pos.it != this) throw invalid_iterator();
+            if (pos.pos <= 0 || pos.pos > length + 1) throw index_out_of_bound();
+            // value may be an element of this deque, which insert_range moves before copying from it
+            T copy(value);
+            repeat r = {&copy};
+            insert_range(pos.pos, r, n);
+            return pos;
+        }
+        template<class It>
+        void append(It first, It last) {
+            insert(end(), first, last);
+        }
+        template<class It>
+        void prepend(It first, It last) {
+            insert(begin(), first, last);
+        }
+        /**
+         * p and p->next have just been linked together from two deques, so either may be an end block under
+         * half full that is now in the middle. Merge them if they fit in one block, which copies at most one
+         * block's worth, and otherwise let fix() borrow for whichever of the two is short.
+         */
+        void join(block *p) {
+            block *q = p->next;
+            if (p == head || q == tail) return;
+            if (p->len + q->len <= p->size) {
+                merge(p);
+                fix(p);
+            }
+            else if (p->len < p->size / 2) fix(p);
+            else fix(q);
+        }
+        /**
+         * leave this deque empty without touching its blocks, which another deque has just taken over;
+         * the spare blocks stay, so the deque can be filled again without going to the allocator
+         */
+        void disown() {
+            head->next = tail;
+            tail->last = head;
+            length = blocknum = 0;
+            dirty = true;
+        }
+        /**
+         * Move every element of other onto the end of this deque by relinking its blocks, in
+         * O(1) apart from the merge or borrow at the seam. The directory is rebuilt by the next indexed
+         * lookup. other is left empty but keeps its spare blocks.
+         */
+        void splice_back(deque &&other) {
+            if (&other == this || other.length == 0) return;
+            block *p = tail->last, *first = other.head->next, *last = other.tail->last;
+            p->next = first;
+            first->last = p;
+            last->next = tail;
+            tail->last = last;
+            length += other.length;
+            blocknum += other.blocknum;
+            note_use(blocknum);
+            dirty = true;
+            other.disown();
+            join(p);
+        }
+        void splice_front(deque &&other) {
+            if (&other == this || other.length == 0) return;
+            block *p = other.tail->last, *first = other.head->next, *next = head->next;
+            head->next = first;
+            first->last = head;
+            p->next = next;
+            next->last = p;
+            length += other.length;
+            blocknum += other.blocknum;
+            note_use(blocknum);
+            dirty = true;
+            other.disown();
+            join(p);
+        }
+        /**
+         * Cut the deque before pos: the elements from pos on are returned in a new deque, and this one keeps
+         * those before it. Only the block pos falls in is split, so the cost is a lookup, moving the rest of
+         * that one block, and relinking; both halves keep their end blocks at the cut, which may be partial.
+         */
+        deque split_at(iterator pos) {
+            if (pos.it != this) throw invalid_iterator();
+            int start = pos.pos, i;
+            if (start <= 0 || start > length + 1) throw index_out_of_bound();
+            deque ret;
+            if (start == length + 1) return ret;
+            block *p;
+            findPos(start, i, p);
+            if (i > 1) {
+                split(p, i - 1);
+                p = p->next;
+            }
+            // findPos has just rebuilt the directory if it was dirty, and split keeps it up to date
+            block *first = p, *last = tail->last, *keep = p->last;
+            ret.head->next = first;
+            first->last = ret.head;
+            ret.tail->last = last;
+            last->next = ret.tail;
+            ret.length = length - (start - 1);
+            ret.blocknum = blocknum - first->id;
+            ret.note_use(ret.blocknum);
+            keep->next = tail;
+            tail->last = keep;
+            length = start - 1;
+            blocknum = dirnum = first->id;
+            for (dirtop = 1; dirtop * 2 <= dirnum; dirtop *= 2);
+            return ret;
+        }
         iterator erase(iterator pos) {
             if (pos.it != this) throw invalid_iterator();
             int start = pos.pos, n;
             if (start <= 0 || start > length) throw index_out_of_bound();
             block *p;
             findPos(start, n, p);
-            split(p, n);
-            p->data[p->len - 1].~T();
-            --p->len;
+            erase_at(p, n - 1);
             --length;
-            merge(p);
+            fix(p);
             return iterator(start, this);
         }
         void push_back(const T &value) {
-            block *tmp;
-            tmp = new block;
-            ++blocknum;
             block *p = tail->last;
-            tmp->next = tail;
-            tail->last = tmp;
-            tmp->last = p;
-            p->next = tmp;
-            new(tmp->data) T(value);
+            if (p == head || p->len == p->size) p = add_block(p);
+            new(p->data + p->len) T(value);
+            ++p->len;
+            resize(p, 1);
+            ++length;
+        }
+        void push_back(T &&value) {
+            block *p = tail->last;
+            if (p == head || p->len == p->size) p = add_block(p);
+            new(p->data + p->len) T(std::move(value));
+            ++p->len;
+            resize(p, 1);
             ++length;
-            ++tmp->len;
-            merge(p);
         }
         void pop_back() {
             if (length == 0) throw container_is_empty();
             block *p = tail->last;
             p->data[p->len - 1].~T();
             --p->len;
+            resize(p, -1);
             --length;
-            if (p->last != head) merge(p->last);
+            drop_empty(p);
         }
         void push_front(const T &value) {
-            block *tmp;
-            tmp = new block;
-            ++blocknum;
+            // value may be the current front, which the shift below moves
+            T copy(value);
             block *p = head->next;
-            tmp->next = p;
-            p->last = tmp;
-            head->next = tmp;
-            tmp->last = head;
-            new(tmp->data) T(value);
+            if (p == tail || p->len == p->size) p = add_block(head);
+            insert_at(p, 0, std::move(copy));
+            ++length;
+        }
+        void push_front(T &&value) {
+            block *p = head->next;
+            if (p == tail || p->len == p->size) p = add_block(head);
+            insert_at(p, 0, std::move(value));
             ++length;
-            ++tmp->len;
-            merge(tmp);
         }
         void pop_front() {
             if (length == 0) throw container_is_empty();
             block *p = head->next;
-            for (int i = 0; i < p->len - 1; ++i)
-                p->data[i] = p->data[i + 1];
-            p->data[p->len - 1].~T();
-            --p->len;
+            erase_at(p, 0);
             --length;
-            merge(p);
+            drop_empty(p);
         }
     };
 
+    template<class T, int BlockSize>
+    void swap(deque<T, BlockSize> &a, deque<T, BlockSize> &b) noexcept {
+        a.swap(b);
+    }
+
 }
 
 #endif
@@ -0,0 +1,573 @@
+#ifndef SJTU_INDEXED_SEQUENCE_HPP
+#define SJTU_INDEXED_SEQUENCE_HPP
+
+#include "exceptions.hpp"
+#include "deque1.hpp"
+
+#include <cstddef>
+#include <utility>
+
+namespace sjtu {
+
+    /**
+     * A sequence with the interface of sjtu::deque kept in a B+tree. Elements sit in leaves of at most
+     * LeafSize, and each inner node keeps, next to every child, the number of elements below it, so
+     * indexing, insert and erase anywhere descend one path and cost O(log n) plus one leaf shift.
+     * Every node but the root is at least half full; an empty sequence owns no memory.
+     */
+    template<class T, int LeafSize = deque_block<T>::value, int Fanout = 64>
+    class indexed_sequence {
+        static_assert(LeafSize >= 4 && Fanout >= 4, "nodes must hold at least 4 entries");
+    public:
+        struct node {
+            int num;
+            bool leaf;
+            node(bool l): num(0), leaf(l) {}
+        };
+        struct leaf_node: node {
+            T *data;
+            leaf_node(): node(true) {
+                data = (T*) (operator new (LeafSize * sizeof(T)));
+            }
+            ~leaf_node() {
+                for (int i = 0; i < this->num; ++i)
+                    data[i].~T();
+                operator delete (data);
+            }
+        };
+        /**
+         * one spare slot lets a node overflow by a child before it is split
+         */
+        struct inner_node: node {
+            node *child[Fanout + 1];
+            int cnt[Fanout + 1];
+            inner_node(): node(false) {}
+        };
+
+        node *root;
+        int length;
+
+        static leaf_node *as_leaf(node *p) {
+            return static_cast<leaf_node*>(p);
+        }
+        static inner_node *as_inner(node *p) {
+            return static_cast<inner_node*>(p);
+        }
+        static int count(node *p) {
+            if (p->leaf) return p->num;
+            int ret = 0;
+            inner_node *q = as_inner(p);
+            for (int i = 0; i < q->num; ++i)
+                ret += q->cnt[i];
+            return ret;
+        }
+        static int capacity(node *p) {
+            return p->leaf ? LeafSize : Fanout;
+        }
+        static void destroy(node *p) {
+            if (p->leaf) {
+                delete as_leaf(p);
+                return;
+            }
+            inner_node *q = as_inner(p);
+            for (int i = 0; i < q->num; ++i)
+                destroy(q->child[i]);
+            delete q;
+        }
+        static node *clone(node *p) {
+            if (p->leaf) {
+                leaf_node *q = as_leaf(p), *ret = new leaf_node;
+                try {
+                    for (; ret->num < q->num; ++ret->num)
+                        new(ret->data + ret->num) T(q->data[ret->num]);
+                } catch (...) {
+                    delete ret;
+                    throw;
+                }
+                return ret;
+            }
+            inner_node *q = as_inner(p), *ret = new inner_node;
+            try {
+                for (; ret->num < q->num; ++ret->num) {
+                    ret->child[ret->num] = clone(q->child[ret->num]);
+                    ret->cnt[ret->num] = q->cnt[ret->num];
+                }
+            } catch (...) {
+                destroy(ret);
+                throw;
+            }
+            return ret;
+        }
+
+        /**
+         * shift p->data[i..num) right by one and move value in at i; the leaf has room
+         */
+        static void leaf_insert(leaf_node *p, int i, T &&value) {
+            if (i == p->num) new(p->data + i) T(std::move(value));
+            else {
+                new(p->data + p->num) T(std::move(p->data[p->num - 1]));
+                for (int j = p->num - 1; j > i; --j)
+                    p->data[j] = std::move(p->data[j - 1]);
+                p->data[i] = std::move(value);
+            }
+            ++p->num;
+        }
+        static void leaf_erase(leaf_node *p, int i) {
+            for (int j = i; j < p->num - 1; ++j)
+                p->data[j] = std::move(p->data[j + 1]);
+            --p->num;
+            p->data[p->num].~T();
+        }
+        /**
+         * move the entries of p from index k on to the front of q, which holds nothing yet
+         */
+        static void move_tail(leaf_node *p, int k, leaf_node *q) {
+            for (int i = k; i < p->num; ++i, ++q->num) {
+                new(q->data + q->num) T(std::move(p->data[i]));
+                p->data[i].~T();
+            }
+            p->num = k;
+        }
+        static void move_tail(inner_node *p, int k, inner_node *q) {
+            for (int i = k; i < p->num; ++i, ++q->num) {
+                q->child[q->num] = p->child[i];
+                q->cnt[q->num] = p->cnt[i];
+            }
+            p->num = k;
+        }
+        /**
+         * the child of p holding the element at index k, with k made relative to it;
+         * an index equal to the subtree size goes to the last child
+         */
+        static int locate(inner_node *p, int &k) {
+            int i = 0;
+            while (i < p->num - 1 && k >= p->cnt[i]) {
+                k -= p->cnt[i];
+                ++i;
+            }
+            return i;
+        }
+        /**
+         * put value at index k below p; if p had to split, the new right half is returned
+         */
+        static node *insert_at(node *p, int k, T &&value) {
+            if (p->leaf) {
+                leaf_node *q = as_leaf(p);
+                if (q->num < LeafSize) {
+                    leaf_insert(q, k, std::move(value));
+                    return nullptr;
+                }
+                leaf_node *r = new leaf_node;
+                move_tail(q, LeafSize / 2, r);
+                if (k <= q->num) leaf_insert(q, k, std::move(value));
+                else leaf_insert(r, k - q->num, std::move(value));
+                return r;
+            }
+            inner_node *q = as_inner(p);
+            int i = q->num - 1, rest = k;
+            // an insert at the very end of a child goes into that child rather than the next one
+            for (int j = 0; j < q->num; ++j) {
+                if (rest <= q->cnt[j]) {
+                    i = j;
+                    break;
+                }
+                rest -= q->cnt[j];
+            }
+            node *r = insert_at(q->child[i], rest, std::move(value));
+            ++q->cnt[i];
+            if (r == nullptr) return nullptr;
+            for (int j = q->num; j > i + 1; --j) {
+                q->child[j] = q->child[j - 1];
+                q->cnt[j] = q->cnt[j - 1];
+            }
+            q->child[i + 1] = r;
+            q->cnt[i + 1] = count(r);
+            q->cnt[i] -= q->cnt[i + 1];
+            ++q->num;
+            if (q->num <= Fanout) return nullptr;
+            inner_node *s = new inner_node;
+            move_tail(q, q->num / 2, s);
+            return s;
+        }
+        /**
+         * remove the element at index k below p, then refill any child left under half full
+         */
+        static void erase_at(node *p, int k) {
+            if (p->leaf) {
+                leaf_erase(as_leaf(p), k);
+                return;
+            }
+            inner_node *q = as_inner(p);
+            int i = locate(q, k);
+            erase_at(q->child[i], k);
+            --q->cnt[i];
+            if (q->child[i]->num < capacity(q->child[i]) / 2 && q->num > 1) rebalance(q, i);
+        }
+        /**
+         * child i of p has fallen below half: merge it with a neighbour if both fit in one node,
+         * or else take one entry from the neighbour
+         */
+        static void rebalance(inner_node *p, int i) {
+            int a = i + 1 < p->num ? i : i - 1, b = a + 1;
+            node *l = p->child[a], *r = p->child[b];
+            if (l->num + r->num <= capacity(l)) {
+                if (l->leaf) {
+                    leaf_node *x = as_leaf(l), *y = as_leaf(r);
+                    for (int j = 0; j < y->num; ++j, ++x->num)
+                        new(x->data + x->num) T(std::move(y->data[j]));
+                }
+                else {
+                    inner_node *x = as_inner(l), *y = as_inner(r);
+                    for (int j = 0; j < y->num; ++j, ++x->num) {
+                        x->child[x->num] = y->child[j];
+                        x->cnt[x->num] = y->cnt[j];
+                    }
+                    y->num = 0;
+                }
+                destroy(r);
+                p->cnt[a] += p->cnt[b];
+                for (int j = b; j < p->num - 1; ++j) {
+                    p->child[j] = p->child[j + 1];
+                    p->cnt[j] = p->cnt[j + 1];
+                }
+                --p->num;
+                return;
+            }
+            int moved;
+            if (l->leaf) {
+                leaf_node *x = as_leaf(l), *y = as_leaf(r);
+                if (i == a) {
+                    new(x->data + x->num) T(std::move(y->data[0]));
+                    ++x->num;
+                    leaf_erase(y, 0);
+                }
+                else {
+                    leaf_insert(y, 0, std::move(x->data[x->num - 1]));
+                    --x->num;
+                    x->data[x->num].~T();
+                }
+                moved = 1;
+            }
+            else {
+                inner_node *x = as_inner(l), *y = as_inner(r);
+                if (i == a) {
+                    x->child[x->num] = y->child[0];
+                    moved = x->cnt[x->num] = y->cnt[0];
+                    ++x->num;
+                    for (int j = 0; j < y->num - 1; ++j) {
+                        y->child[j] = y->child[j + 1];
+                        y->cnt[j] = y->cnt[j + 1];
+                    }
+                    --y->num;
+                }
+                else {
+                    for (int j = y->num; j > 0; --j) {
+                        y->child[j] = y->child[j - 1];
+                        y->cnt[j] = y->cnt[j - 1];
+                    }
+                    --x->num;
+                    y->child[0] = x->child[x->num];
+                    moved = y->cnt[0] = x->cnt[x->num];
+                    ++y->num;
+                }
+            }
+            if (i == a) p->cnt[a] += moved, p->cnt[b] -= moved;
+            else p->cnt[a] -= moved, p->cnt[b] += moved;
+        }
+        T &get(int k) const {
+            node *p = root;
+            while (!p->leaf) {
+                inner_node *q = as_inner(p);
+                p = q->child[locate(q, k)];
+            }
+            return as_leaf(p)->data[k];
+        }
+        /**
+         * the number of levels, 0 when empty
+         */
+        int depth() const {
+            int ret = 0;
+            for (node *p = root; p != nullptr; p = p->leaf ? nullptr : as_inner(p)->child[0])
+                ++ret;
+            return ret;
+        }
+
+        class const_iterator;
+        class iterator {
+        private:
+            friend const_iterator;
+        public:
+            int pos;
+            indexed_sequence *it;
+            iterator (int obj1 = 0, indexed_sequence *obj2 = nullptr) {
+                pos = obj1;
+                it = obj2;
+            }
+            iterator operator+(const int &n) const {
+                return iterator(pos + n, it);
+            }
+            iterator operator-(const int &n) const {
+                return iterator(pos - n, it);
+            }
+            int operator-(const iterator &rhs) const {
+                if (it != rhs.it) throw invalid_iterator();
+                return (pos - rhs.pos);
+            }
+            iterator& operator+=(const int &n) {
+                pos += n;
+                return *this;
+            }
+            iterator& operator-=(const int &n) {
+                pos -= n;
+                return *this;
+            }
+            iterator operator++(int) {
+                iterator tmp = *this;
+                ++pos;
+                return tmp;
+            }
+            iterator& operator++() {
+                ++pos;
+                return *this;
+            }
+            iterator operator--(int) {
+                iterator tmp = *this;
+                --pos;
+                return tmp;
+            }
+            iterator& operator--() {
+                --pos;
+                return *this;
+            }
+            T& operator*() const {
+                if (pos >= it->length + 1 || pos <= 0) throw index_out_of_bound();
+                return it->get(pos - 1);
+            }
+            T* operator->() const {
+                return &**this;
+            }
+            bool operator==(const iterator &rhs) const {
+                return rhs.pos == pos && rhs.it == it;
+            }
+            bool operator==(const const_iterator &rhs) const {
+                return rhs.pos == pos && rhs.it == it;
+            }
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+        class const_iterator {
+        private:
+            friend iterator;
+        public:
+            int pos;
+            const indexed_sequence *it;
+            const_iterator (int obj1 = 0, const indexed_sequence *obj2 = nullptr) {
+                pos = obj1;
+                it = obj2;
+            }
+            const_iterator(const iterator &other) {
+                pos = other.pos;
+                it = other.it;
+            }
+            const_iterator operator+(const int &n) const {
+                return const_iterator(pos + n, it);
+            }
+            const_iterator operator-(const int &n) const {
+                return const_iterator(pos - n, it);
+            }
+            int operator-(const const_iterator &rhs) const {
+                if (it != rhs.it) throw invalid_iterator();
+                return (pos - rhs.pos);
+            }
+            const_iterator& operator+=(const int &n) {
+                pos += n;
+                return *this;
+            }
+            const_iterator& operator-=(const int &n) {
+                pos -= n;
+                return *this;
+            }
+            const_iterator operator++(int) {
+                const_iterator tmp = *this;
+                ++pos;
+                return tmp;
+            }
+            const_iterator& operator++() {
+                ++pos;
+                return *this;
+            }
+            const_iterator operator--(int) {
+                const_iterator tmp = *this;
+                --pos;
+                return tmp;
+            }
+            const_iterator& operator--() {
+                --pos;
+                return *this;
+            }
+            const T& operator*() const {
+                if (pos >= it->length + 1 || pos <= 0) throw index_out_of_bound();
+                return it->get(pos - 1);
+            }
+            const T* operator->() const {
+                return &**this;
+            }
+            bool operator==(const iterator &rhs) const {
+                return rhs.pos == pos && rhs.it == it;
+            }
+            bool operator==(const const_iterator &rhs) const {
+                return rhs.pos == pos && rhs.it == it;
+            }
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+
+        indexed_sequence(): root(nullptr), length(0) {}
+        indexed_sequence(const indexed_sequence &other): root(nullptr), length(other.length) {
+            if (other.root != nullptr) root = clone(other.root);
+        }
+        indexed_sequence(indexed_sequence &&other) noexcept: root(other.root), length(other.length) {
+            other.root = nullptr;
+            other.length = 0;
+        }
+        ~indexed_sequence() {
+            clear();
+        }
+        indexed_sequence &operator=(const indexed_sequence &other) {
+            if (this == &other) return *this;
+            node *p = other.root == nullptr ? nullptr : clone(other.root);
+            clear();
+            root = p;
+            length = other.length;
+            return *this;
+        }
+        indexed_sequence &operator=(indexed_sequence &&other) noexcept {
+            if (this == &other) return *this;
+            clear();
+            swap(other);
+            return *this;
+        }
+        void swap(indexed_sequence &other) noexcept {
+            std::swap(root, other.root);
+            std::swap(length, other.length);
+        }
+        T & at(const size_t &pos) {
+            if (pos >= (size_t) length) throw index_out_of_bound();
+            return get(pos);
+        }
+        const T & at(const size_t &pos) const {
+            if (pos >= (size_t) length) throw index_out_of_bound();
+            return get(pos);
+        }
+        T & operator[](const size_t &pos) {
+            return at(pos);
+        }
+        const T & operator[](const size_t &pos) const {
+            return at(pos);
+        }
+        const T & front() const {
+            if (length == 0) throw container_is_empty();
+            return get(0);
+        }
+        const T & back() const {
+            if (length == 0) throw container_is_empty();
+            return get(length - 1);
+        }
+        iterator begin() {
+            return iterator(1, this);
+        }
+        const_iterator cbegin() const {
+            return const_iterator(1, this);
+        }
+        iterator end() {
+            return iterator(length + 1, this);
+        }
+        const_iterator cend() const {
+            return const_iterator(length + 1, this);
+        }
+        bool empty() const {
+            return length == 0;
+        }
+        size_t size() const {
+            return length;
+        }
+        void clear() {
+            if (root != nullptr) destroy(root);
+            root = nullptr;
+            length = 0;
+        }
+        /**
+         * value is copied before anything moves, as it may be an element of this sequence
+         */
+        iterator insert(iterator pos, const T &value) {
+            return insert(pos, T(value));
+        }
+        iterator insert(iterator pos, T &&value) {
+            if (pos.it != this) throw invalid_iterator();
+            if (pos.pos <= 0 || pos.pos > length + 1) throw index_out_of_bound();
+            if (root == nullptr) root = new leaf_node;
+            node *r = insert_at(root, pos.pos - 1, std::move(value));
+            if (r != nullptr) {
+                inner_node *p = new inner_node;
+                p->child[0] = root;
+                p->cnt[0] = length + 1 - count(r);
+                p->child[1] = r;
+                p->cnt[1] = count(r);
+                p->num = 2;
+                root = p;
+            }
+            ++length;
+            return pos;
+        }
+        iterator erase(iterator pos) {
+            if (pos.it != this) throw invalid_iterator();
+            if (pos.pos <= 0 || pos.pos > length) throw index_out_of_bound();
+            erase_at(root, pos.pos - 1);
+            --length;
+            while (!root->leaf && root->num == 1) {
+                node *p = as_inner(root)->child[0];
+                as_inner(root)->num = 0;
+                destroy(root);
+                root = p;
+            }
+            if (length == 0) clear();
+            return pos;
+        }
+        void push_back(const T &value) {
+            insert(end(), value);
+        }
+        void push_back(T &&value) {
+            insert(end(), std::move(value));
+        }
+        void pop_back() {
+            if (length == 0) throw container_is_empty();
+            erase(iterator(length, this));
+        }
+        void push_front(const T &value) {
+            insert(begin(), value);
+        }
+        void push_front(T &&value) {
+            insert(begin(), std::move(value));
+        }
+        void pop_front() {
+            if (length == 0) throw container_is_empty();
+            erase(begin());
+        }
+    };
+
+    template<class T, int LeafSize, int Fanout>
+    void swap(indexed_sequence<T, LeafSize, Fanout> &a, indexed_sequence<T, LeafSize, Fanout> &b) noexcept {
+        a.swap(b);
+    }
+
+}
+
+#endif
@@ -0,0 +1,809 @@
+/**
+ * implement a container like std::map as an adaptive radix tree, for integer and string keys
+ */
+#ifndef SJTU_ART_MAP_HPP
+#define SJTU_ART_MAP_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+    /**
+     * the encoded bytes of a key: either up to 8 bytes held inline, or a view of bytes the key
+     * already owns, so encoding never allocates
+     */
+    struct art_bytes {
+        const char *ptr;
+        size_t len;
+        char buf[8];
+
+        art_bytes(): ptr(nullptr), len(0) {}
+        const char *data() const {
+            return ptr == nullptr ? buf : ptr;
+        }
+        size_t size() const {
+            return len;
+        }
+        unsigned char operator[](size_t i) const {
+            return (unsigned char) data()[i];
+        }
+        int compare(const art_bytes &other) const {
+            int c = memcmp(data(), other.data(), len < other.len ? len : other.len);
+            if (c != 0) return c;
+            return len < other.len ? -1 : len > other.len ? 1 : 0;
+        }
+        bool operator==(const art_bytes &other) const {
+            return len == other.len && memcmp(data(), other.data(), len) == 0;
+        }
+    };
+
+    /**
+     * turns a key into bytes whose lexicographic order is the order of the keys; a view may point
+     * into the key, which outlives it
+     */
+    template<class Key, class Enable = void>
+    struct art_key;
+
+    template<class Key>
+    struct art_key<Key, typename std::enable_if<std::is_integral<Key>::value>::type> {
+        static_assert(sizeof(Key) <= 8, "art_key holds at most 8 bytes inline");
+        static void encode(const Key &key, art_bytes &out) {
+            unsigned long long u = (unsigned long long) key;
+            if (std::is_signed<Key>::value) u ^= 1ull << (sizeof(Key) * 8 - 1);
+            out.ptr = nullptr;
+            out.len = sizeof(Key);
+            for (int i = sizeof(Key) - 1; i >= 0; --i, u >>= 8) out.buf[i] = (char) (u & 255);
+        }
+    };
+
+    template<>
+    struct art_key<std::string> {
+        static void encode(const std::string &key, art_bytes &out) {
+            out.ptr = key.data();
+            out.len = key.size();
+        }
+    };
+
+    /**
+     * Inner nodes grow through 4, 16, 48 and 256 children and keep up to MAX_PREFIX bytes of their
+     * compressed path; longer paths are checked against a leaf instead. A key that is a proper prefix
+     * of other keys hangs off the inner node where it ends, as its term leaf.
+     * Leaves are chained in key order, which is what the iterators walk. A leaf keeps only its
+     * element and encodes the key again from it when the tree needs the bytes.
+     */
+    template<
+            class Key,
+            class T,
+            class Traits = art_key<Key>
+    > class art_map {
+    public:
+        typedef pair<const Key, T> value_type;
+        enum { LEAF, NODE4, NODE16, NODE48, NODE256 };
+        static const unsigned MAX_PREFIX = 10;
+        struct node {
+            unsigned char type;
+            explicit node(unsigned char t): type(t) {}
+        };
+        struct leaf : node {
+            value_type data;
+            leaf *prev, *next;
+            explicit leaf(const value_type &val): node(LEAF), data(val), prev(nullptr), next(nullptr) {}
+            art_bytes key() const {
+                art_bytes ret;
+                Traits::encode(data.first, ret);
+                return ret;
+            }
+        };
+        struct inner : node {
+            unsigned short count;
+            unsigned prefix_len;
+            unsigned char prefix[MAX_PREFIX];
+            leaf *term;
+            explicit inner(unsigned char t): node(t), count(0), prefix_len(0), term(nullptr) {}
+        };
+        struct node4 : inner {
+            unsigned char keys[4];
+            node *child[4];
+            node4(): inner(NODE4) {}
+        };
+        struct node16 : inner {
+            unsigned char keys[16];
+            node *child[16];
+            node16(): inner(NODE16) {}
+        };
+        struct node48 : inner {
+            unsigned char index[256];
+            node *child[48];
+            node48(): inner(NODE48) {
+                memset(index, 0, sizeof(index));
+                memset(child, 0, sizeof(child));
+            }
+        };
+        struct node256 : inner {
+            node *child[256];
+            node256(): inner(NODE256) {
+                memset(child, 0, sizeof(child));
+            }
+        };
+
+        node *root;
+        leaf *head, *tail;
+        int len;
+
+        static unsigned char byte(const art_bytes &k, size_t d) {
+            return k[d];
+        }
+        static void del(node *p) {
+            if (p == nullptr) return;
+            if (p->type == LEAF) {
+                delete static_cast<leaf*>(p);
+                return;
+            }
+            inner *n = static_cast<inner*>(p);
+            for (int c = 0; c < 256; ++c) {
+                node **ch = find_child(n, c);
+                if (ch != nullptr) del(*ch);
+            }
+            if (n->term != nullptr) delete n->term;
+            free_inner(n);
+        }
+        static void free_inner(inner *n) {
+            switch (n->type) {
+                case NODE4: delete static_cast<node4*>(n); break;
+                case NODE16: delete static_cast<node16*>(n); break;
+                case NODE48: delete static_cast<node48*>(n); break;
+                default: delete static_cast<node256*>(n);
+            }
+        }
+        static node **find_child(inner *n, unsigned char c) {
+            switch (n->type) {
+                case NODE4: {
+                    node4 *p = static_cast<node4*>(n);
+                    for (int i = 0; i < p->count; ++i)
+                        if (p->keys[i] == c) return &p->child[i];
+                    return nullptr;
+                }
+                case NODE16: {
+                    node16 *p = static_cast<node16*>(n);
+                    for (int i = 0; i < p->count; ++i)
+                        if (p->keys[i] == c) return &p->child[i];
+                    return nullptr;
+                }
+                case NODE48: {
+                    node48 *p = static_cast<node48*>(n);
+                    if (p->index[c] == 0) return nullptr;
+                    return &p->child[p->index[c] - 1];
+                }
+                default: {
+                    node256 *p = static_cast<node256*>(n);
+                    if (p->child[c] == nullptr) return nullptr;
+                    return &p->child[c];
+                }
+            }
+        }
+        /**
+         * first child whose byte is >= c (> c when strict), nullptr if none
+         */
+        static node *child_from(inner *n, int c, bool strict) {
+            if (strict) ++c;
+            switch (n->type) {
+                case NODE4: {
+                    node4 *p = static_cast<node4*>(n);
+                    for (int i = 0; i < p->count; ++i)
+                        if (p->keys[i] >= c) return p->child[i];
+                    return nullptr;
+                }
+                case NODE16: {
+                    node16 *p = static_cast<node16*>(n);
+                    for (int i = 0; i < p->count; ++i)
+                        if (p->keys[i] >= c) return p->child[i];
+                    return nullptr;
+                }
+                case NODE48: {
+                    node48 *p = static_cast<node48*>(n);
+                    for (; c < 256; ++c)
+                        if (p->index[c] != 0) return p->child[p->index[c] - 1];
+                    return nullptr;
+                }
+                default: {
+                    node256 *p = static_cast<node256*>(n);
+                    for (; c < 256; ++c)
+                        if (p->child[c] != nullptr) return p->child[c];
+                    return nullptr;
+                }
+            }
+        }
+        static node *last_child(inner *n) {
+            switch (n->type) {
+                case NODE4: return static_cast<node4*>(n)->child[n->count - 1];
+                case NODE16: return static_cast<node16*>(n)->child[n->count - 1];
+                case NODE48: {
+                    node48 *p = static_cast<node48*>(n);
+                    for (int c = 255; c >= 0; --c)
+                        if (p->index[c] != 0) return p->child[p->index[c] - 1];
+                    return nullptr;
+                }
+                default: {
+                    node256 *p = static_cast<node256*>(n);
+                    for (int c = 255; c >= 0; --c)
+                        if (p->child[c] != nullptr) return p->child[c];
+                    return nullptr;
+                }
+            }
+        }
+        static leaf *min_leaf(node *p) {
+            while (p->type != LEAF) {
+                inner *n = static_cast<inner*>(p);
+                if (n->term != nullptr) return n->term;
+                p = child_from(n, 0, false);
+            }
+            return static_cast<leaf*>(p);
+        }
+        static leaf *max_leaf(node *p) {
+            while (p->type != LEAF) {
+                inner *n = static_cast<inner*>(p);
+                if (n->count == 0) return n->term;
+                p = last_child(n);
+            }
+            return static_cast<leaf*>(p);
+        }
+        static void copy_header(inner *to, inner *from) {
+            to->count = from->count;
+            to->prefix_len = from->prefix_len;
+            memcpy(to->prefix, from->prefix, MAX_PREFIX);
+            to->term = from->term;
+        }
+        static void set_prefix(inner *n, const art_bytes &src, size_t from, unsigned len) {
+            n->prefix_len = len;
+            for (unsigned i = 0; i < len && i < MAX_PREFIX; ++i) n->prefix[i] = byte(src, from + i);
+        }
+        /**
+         * byte i of the compressed path of n, which starts at depth d
+         */
+        static unsigned char prefix_byte(inner *n, unsigned i, size_t d) {
+            if (i < MAX_PREFIX) return n->prefix[i];
+            return byte(min_leaf(n)->key(), d + i);
+        }
+        static void add_child(node *&ref, unsigned char c, node *child) {
+            inner *n = static_cast<inner*>(ref);
+            switch (n->type) {
+                case NODE4: {
+                    node4 *p = static_cast<node4*>(n);
+                    if (p->count == 4) {
+                        node16 *q = new node16;
+                        copy_header(q, p);
+                        memcpy(q->keys, p->keys, 4);
+                        memcpy(q->child, p->child, 4 * sizeof(node*));
+                        delete p;
+                        ref = q;
+                        add_child(ref, c, child);
+                        return;
+                    }
+                    int i = p->count;
+                    while (i > 0 && p->keys[i - 1] > c) {
+                        p->keys[i] = p->keys[i - 1];
+                        p->child[i] = p->child[i - 1];
+                        --i;
+                    }
+                    p->keys[i] = c;
+                    p->child[i] = child;
+                    ++p->count;
+                    return;
+                }
+                case NODE16: {
+                    node16 *p = static_cast<node16*>(n);
+                    if (p->count == 16) {
+                        node48 *q = new node48;
+                        copy_header(q, p);
+                        for (int i = 0; i < 16; ++i) {
+                            q->child[i] = p->child[i];
+                            q->index[p->keys[i]] = i + 1;
+                        }
+                        delete p;
+                        ref = q;
+                        add_child(ref, c, child);
+                        return;
+                    }
+                    int i = p->count;
+                    while (i > 0 && p->keys[i - 1] > c) {
+                        p->keys[i] = p->keys[i - 1];
+                        p->child[i] = p->child[i - 1];
+                        --i;
+                    }
+                    p->keys[i] = c;
+                    p->child[i] = child;
+                    ++p->count;
+                    return;
+                }
+                case NODE48: {
+                    node48 *p = static_cast<node48*>(n);
+                    if (p->count == 48) {
+                        node256 *q = new node256;
+                        copy_header(q, p);
+                        for (int b = 0; b < 256; ++b)
+                            if (p->index[b] != 0) q->child[b] = p->child[p->index[b] - 1];
+                        delete p;
+                        ref = q;
+                        add_child(ref, c, child);
+                        return;
+                    }
+                    int slot = 0;
+                    while (p->child[slot] != nullptr) ++slot;
+                    p->child[slot] = child;
+                    p->index[c] = slot + 1;
+                    ++p->count;
+                    return;
+                }
+                default: {
+                    node256 *p = static_cast<node256*>(n);
+                    p->child[c] = child;
+                    ++p->count;
+                }
+            }
+        }
+        static void remove_child(node *&ref, unsigned char c) {
+            inner *n = static_cast<inner*>(ref);
+            switch (n->type) {
+                case NODE4: {
+                    node4 *p = static_cast<node4*>(n);
+                    int i = 0;
+                    while (p->keys[i] != c) ++i;
+                    for (; i + 1 < p->count; ++i) {
+                        p->keys[i] = p->keys[i + 1];
+                        p->child[i] = p->child[i + 1];
+                    }
+                    --p->count;
+                    return;
+                }
+                case NODE16: {
+                    node16 *p = static_cast<node16*>(n);
+                    int i = 0;
+                    while (p->keys[i] != c) ++i;
+                    for (; i + 1 < p->count; ++i) {
+                        p->keys[i] = p->keys[i + 1];
+                        p->child[i] = p->child[i + 1];
+                    }
+                    --p->count;
+                    if (p->count > 3) return;
+                    node4 *q = new node4;
+                    copy_header(q, p);
+                    memcpy(q->keys, p->keys, p->count);
+                    memcpy(q->child, p->child, p->count * sizeof(node*));
+                    delete p;
+                    ref = q;
+                    return;
+                }
+                case NODE48: {
+                    node48 *p = static_cast<node48*>(n);
+                    int slot = p->index[c] - 1;
+                    p->index[c] = 0;
+                    p->child[slot] = nullptr;
+                    --p->count;
+                    if (p->count > 12) return;
+                    node16 *q = new node16;
+                    copy_header(q, p);
+                    q->count = 0;
+                    for (int b = 0; b < 256; ++b)
+                        if (p->index[b] != 0) {
+                            q->keys[q->count] = b;
+                            q->child[q->count++] = p->child[p->index[b] - 1];
+                        }
+                    delete p;
+                    ref = q;
+                    return;
+                }
+                default: {
+                    node256 *p = static_cast<node256*>(n);
+                    p->child[c] = nullptr;
+                    --p->count;
+                    if (p->count > 37) return;
+                    node48 *q = new node48;
+                    copy_header(q, p);
+                    q->count = 0;
+                    for (int b = 0; b < 256; ++b)
+                        if (p->child[b] != nullptr) {
+                            q->child[q->count] = p->child[b];
+                            q->index[b] = ++q->count;
+                        }
+                    delete p;
+                    ref = q;
+                }
+            }
+        }
+        leaf *search(const art_bytes &k) const {
+            node *p = root;
+            size_t d = 0;
+            while (p != nullptr) {
+                if (p->type == LEAF) {
+                    leaf *l = static_cast<leaf*>(p);
+                    return l->key() == k ? l : nullptr;
+                }
+                inner *n = static_cast<inner*>(p);
+                for (unsigned i = 0; i < n->prefix_len && i < MAX_PREFIX; ++i)
+                    if (d + i >= k.size() || n->prefix[i] != byte(k, d + i)) return nullptr;
+                d += n->prefix_len;
+                if (d > k.size()) return nullptr;
+                if (d == k.size()) return n->term != nullptr && n->term->key() == k ? n->term : nullptr;
+                node **ch = find_child(n, byte(k, d));
+                if (ch == nullptr) return nullptr;
+                p = *ch;
+                ++d;
+            }
+            return nullptr;
+        }
+        /**
+         * first leaf under p whose key is >= k, nullptr if every key there is smaller
+         */
+        static leaf *lower(node *p, const art_bytes &k, size_t d) {
+            if (p->type == LEAF) {
+                leaf *l = static_cast<leaf*>(p);
+                return l->key().compare(k) >= 0 ? l : nullptr;
+            }
+            inner *n = static_cast<inner*>(p);
+            for (unsigned i = 0; i < n->prefix_len; ++i) {
+                if (d + i == k.size()) return min_leaf(n);
+                unsigned char b = prefix_byte(n, i, d);
+                if (b > byte(k, d + i)) return min_leaf(n);
+                if (b < byte(k, d + i)) return nullptr;
+            }
+            d += n->prefix_len;
+            if (d == k.size()) return min_leaf(n);
+            node **ch = find_child(n, byte(k, d));
+            if (ch != nullptr) {
+                leaf *ret = lower(*ch, k, d + 1);
+                if (ret != nullptr) return ret;
+            }
+            node *next = child_from(n, byte(k, d), true);
+            return next == nullptr ? nullptr : min_leaf(next);
+        }
+        void insert_leaf(node *&ref, leaf *l, size_t d) {
+            art_bytes k = l->key();
+            if (ref == nullptr) {
+                ref = l;
+                return;
+            }
+            if (ref->type == LEAF) {
+                leaf *old = static_cast<leaf*>(ref);
+                art_bytes ok = old->key();
+                size_t i = d;
+                while (i < k.size() && i < ok.size() && k[i] == ok[i]) ++i;
+                node *nn = new node4;
+                set_prefix(static_cast<inner*>(nn), k, d, i - d);
+                if (ok.size() == i) static_cast<inner*>(nn)->term = old;
+                else add_child(nn, byte(ok, i), old);
+                if (k.size() == i) static_cast<inner*>(nn)->term = l;
+                else add_child(nn, byte(k, i), l);
+                ref = nn;
+                return;
+            }
+            inner *n = static_cast<inner*>(ref);
+            if (n->prefix_len > 0) {
+                unsigned p = 0;
+                while (p < n->prefix_len && d + p < k.size() && prefix_byte(n, p, d) == byte(k, d + p)) ++p;
+                if (p < n->prefix_len) {
+                    node *nn = new node4;
+                    art_bytes mk = min_leaf(n)->key();
+                    set_prefix(static_cast<inner*>(nn), mk, d, p);
+                    unsigned char b = byte(mk, d + p);
+                    set_prefix(n, mk, d + p + 1, n->prefix_len - p - 1);
+                    add_child(nn, b, n);
+                    if (k.size() == d + p) static_cast<inner*>(nn)->term = l;
+                    else add_child(nn, byte(k, d + p), l);
+                    ref = nn;
+                    return;
+                }
+                d += n->prefix_len;
+            }
+            if (d == k.size()) {
+                n->term = l;
+                return;
+            }
+            node **ch = find_child(n, byte(k, d));
+            if (ch != nullptr) insert_leaf(*ch, l, d + 1);
+            else add_child(ref, byte(k, d), l);
+        }
+        /**
+         * replace an inner node left with a single branch by that branch
+         */
+        static void collapse(node *&ref, size_t d) {
+            inner *n = static_cast<inner*>(ref);
+            if (n->count == 0) {
+                ref = n->term;
+                free_inner(n);
+                return;
+            }
+            if (n->count > 1 || n->term != nullptr) return;
+            node *c = child_from(n, 0, false);
+            if (c->type != LEAF) {
+                inner *ci = static_cast<inner*>(c);
+                set_prefix(ci, min_leaf(ci)->key(), d, n->prefix_len + 1 + ci->prefix_len);
+            }
+            ref = c;
+            free_inner(n);
+        }
+        void erase_leaf(node *&ref, const art_bytes &k, size_t d) {
+            if (ref->type == LEAF) {
+                ref = nullptr;
+                return;
+            }
+            inner *n = static_cast<inner*>(ref);
+            size_t start = d;
+            d += n->prefix_len;
+            if (d == k.size()) n->term = nullptr;
+            else {
+                node **ch = find_child(n, byte(k, d));
+                if ((*ch)->type == LEAF) remove_child(ref, byte(k, d));
+                else erase_leaf(*ch, k, d + 1);
+            }
+            collapse(ref, start);
+        }
+        void copy(const art_map &other) {
+            root = nullptr;
+            head = tail = nullptr;
+            len = 0;
+            for (leaf *p = other.head; p != nullptr; p = p->next) {
+                leaf *l = new leaf(p->data);
+                insert_leaf(root, l, 0);
+                l->prev = tail;
+                if (tail != nullptr) tail->next = l;
+                else head = l;
+                tail = l;
+                ++len;
+            }
+        }
+        class const_iterator;
+        class iterator {
+        private:
+            friend const_iterator;
+        public:
+            leaf *pos;
+            art_map *it;
+            iterator(leaf *obj1 = nullptr, art_map *obj2 = nullptr) {
+                pos = obj1;
+                it = obj2;
+            }
+            iterator operator++(int) {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+            iterator & operator++() {
+                if (pos == nullptr) throw invalid_iterator();
+                pos = pos->next;
+                return *this;
+            }
+            iterator operator--(int) {
+                iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+            iterator & operator--() {
+                leaf *p = pos == nullptr ? it->tail : pos->prev;
+                if (p == nullptr) throw invalid_iterator();
+                pos = p;
+                return *this;
+            }
+            value_type & operator*() const {
+                return pos->data;
+            }
+            value_type* operator->() const noexcept {
+                return &(pos->data);
+            }
+            bool operator==(const iterator &rhs) const {
+                return pos == rhs.pos && it == rhs.it;
+            }
+            bool operator==(const const_iterator &rhs) const {
+                return pos == rhs.pos && it == rhs.it;
+            }
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+        class const_iterator {
+        private:
+            friend iterator;
+        public:
+            leaf *pos;
+            const art_map *it;
+            const_iterator(leaf *obj1 = nullptr, const art_map *obj2 = nullptr) {
+                pos = obj1;
+                it = obj2;
+            }
+            const_iterator(const iterator &other) {
+                pos = other.pos;
+                it = other.it;
+            }
+            const_iterator operator++(int) {
+                const_iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+            const_iterator & operator++() {
+                if (pos == nullptr) throw invalid_iterator();
+                pos = pos->next;
+                return *this;
+            }
+            const_iterator operator--(int) {
+                const_iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+            const_iterator & operator--() {
+                leaf *p = pos == nullptr ? it->tail : pos->prev;
+                if (p == nullptr) throw invalid_iterator();
+                pos = p;
+                return *this;
+            }
+            const value_type & operator*() const {
+                return pos->data;
+            }
+            const value_type* operator->() const noexcept {
+                return &(pos->data);
+            }
+            bool operator==(const iterator &rhs) const {
+                return pos == rhs.pos && it == rhs.it;
+            }
+            bool operator==(const const_iterator &rhs) const {
+                return pos == rhs.pos && it == rhs.it;
+            }
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+        art_map() {
+            root = nullptr;
+            head = tail = nullptr;
+            len = 0;
+        }
+        art_map(const art_map &other) {
+            copy(other);
+        }
+        art_map & operator=(const art_map &other) {
+            if (this == &other) return *this;
+            clear();
+            copy(other);
+            return *this;
+        }
+        art_map(art_map &&other) noexcept: root(other.root), head(other.head), tail(other.tail), len(other.len) {
+            other.root = nullptr;
+            other.head = other.tail = nullptr;
+            other.len = 0;
+        }
+        art_map & operator=(art_map &&other) noexcept {
+            if (this == &other) return *this;
+            clear();
+            swap(other);
+            return *this;
+        }
+        void swap(art_map &other) noexcept {
+            std::swap(root, other.root);
+            std::swap(head, other.head);
+            std::swap(tail, other.tail);
+            std::swap(len, other.len);
+        }
+        ~art_map() {
+            clear();
+        }
+        T & at(const Key &key) {
+            art_bytes k;
+            Traits::encode(key, k);
+            leaf *tmp = search(k);
+            if (tmp == nullptr) throw index_out_of_bound();
+            return tmp->data.second;
+        }
+        const T & at(const Key &key) const {
+            art_bytes k;
+            Traits::encode(key, k);
+            leaf *tmp = search(k);
+            if (tmp == nullptr) throw index_out_of_bound();
+            return tmp->data.second;
+        }
+        T & operator[](const Key &key) {
+            art_bytes k;
+            Traits::encode(key, k);
+            leaf *tmp = search(k);
+            if (tmp != nullptr) return tmp->data.second;
+            return insert(value_type(key, T())).first->second;
+        }
+        const T & operator[](const Key &key) const {
+            return at(key);
+        }
+        iterator begin() {
+            return iterator(head, this);
+        }
+        const_iterator cbegin() const {
+            return const_iterator(head, this);
+        }
+        iterator end() {
+            return iterator(nullptr, this);
+        }
+        const_iterator cend() const {
+            return const_iterator(nullptr, this);
+        }
+        bool empty() const {
+            return len == 0;
+        }
+        size_t size() const {
+            return len;
+        }
+        void clear() {
+            del(root);
+            root = nullptr;
+            head = tail = nullptr;
+            len = 0;
+        }
+        pair<iterator, bool> insert(const value_type &value) {
+            art_bytes k;
+            Traits::encode(value.first, k);
+            leaf *tmp = search(k);
+            if (tmp != nullptr) return pair<iterator, bool>(iterator(tmp, this), false);
+            leaf *succ = root == nullptr ? nullptr : lower(root, k, 0);
+            leaf *l = new leaf(value);
+            insert_leaf(root, l, 0);
+            l->next = succ;
+            l->prev = succ == nullptr ? tail : succ->prev;
+            if (l->prev != nullptr) l->prev->next = l;
+            else head = l;
+            if (succ != nullptr) succ->prev = l;
+            else tail = l;
+            ++len;
+            return pair<iterator, bool>(iterator(l, this), true);
+        }
+        void erase(iterator pos) {
+            leaf *l = pos.pos;
+            if (l == nullptr || this != pos.it) throw index_out_of_bound();
+            erase_leaf(root, l->key(), 0);
+            if (l->prev != nullptr) l->prev->next = l->next;
+            else head = l->next;
+            if (l->next != nullptr) l->next->prev = l->prev;
+            else tail = l->prev;
+            delete l;
+            --len;
+        }
+        size_t count(const Key &key) const {
+            art_bytes k;
+            Traits::encode(key, k);
+            return search(k) == nullptr ? 0 : 1;
+        }
+        iterator find(const Key &key) {
+            art_bytes k;
+            Traits::encode(key, k);
+            return iterator(search(k), this);
+        }
+        const_iterator find(const Key &key) const {
+            art_bytes k;
+            Traits::encode(key, k);
+            return const_iterator(search(k), this);
+        }
+        iterator lower_bound(const Key &key) {
+            art_bytes k;
+            Traits::encode(key, k);
+            return iterator(root == nullptr ? nullptr : lower(root, k, 0), this);
+        }
+        const_iterator lower_bound(const Key &key) const {
+            art_bytes k;
+            Traits::encode(key, k);
+            return const_iterator(root == nullptr ? nullptr : lower(root, k, 0), this);
+        }
+    };
+
+    template<class Key, class T, class Traits>
+    void swap(art_map<Key, T, Traits> &a, art_map<Key, T, Traits> &b) noexcept {
+        a.swap(b);
+    }
+
+}
+
+#endif
@@ -0,0 +1,246 @@
+/**
+ * implement a blocked bloom filter, and a map that consults one before descending the tree
+ */
+#ifndef SJTU_BLOOM_MAP_HPP
+#define SJTU_BLOOM_MAP_HPP
+
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <utility>
+#include "map1.hpp"
+
+namespace sjtu {
+
+    /**
+     * Every key sets its k bits inside one 64-byte block, so a query touches a single cache line.
+     */
+    template<
+            class Key,
+            class Hash = std::hash<Key>
+    > class bloom_filter {
+    public:
+        static const int BLOCK_WORDS = 8;
+        char *raw;
+        uint64_t *bits;
+        size_t blocks;
+        int k;
+        Hash hash;
+
+        static uint64_t mix(uint64_t h) {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+        /**
+         * replace the bits with n cleared blocks; the old buffer is freed only once the new one is in hand,
+         * so a failed allocation leaves the filter as it was
+         */
+        void allocate(size_t n) {
+            char *p = (char*) (operator new (n * BLOCK_WORDS * sizeof(uint64_t) + 64));
+            operator delete (raw);
+            raw = p;
+            blocks = n;
+            bits = (uint64_t*) (raw + (64 - (uintptr_t) raw % 64) % 64);
+            memset(bits, 0, blocks * BLOCK_WORDS * sizeof(uint64_t));
+        }
+        /**
+         * the block for h: its top 32 bits scaled to [0, blocks) by a multiply and shift,
+         * which is enough for any filter under 2^32 blocks (256 GiB)
+         */
+        uint64_t *block(uint64_t h) const {
+            return bits + (size_t) (((h >> 32) * (uint64_t) blocks) >> 32) * BLOCK_WORDS;
+        }
+        bloom_filter(size_t expected = 1024, double fpr = 0.01): raw(nullptr) {
+            reset(expected, fpr);
+        }
+        bloom_filter(const bloom_filter &other): raw(nullptr), k(other.k), hash(other.hash) {
+            allocate(other.blocks);
+            memcpy(bits, other.bits, blocks * BLOCK_WORDS * sizeof(uint64_t));
+        }
+        bloom_filter & operator=(const bloom_filter &other) {
+            if (this == &other) return *this;
+            bloom_filter tmp(other);
+            swap(tmp);
+            return *this;
+        }
+        /**
+         * takes other's bits; other is left with none and admits every key until it is reset
+         */
+        bloom_filter(bloom_filter &&other) noexcept: raw(other.raw), bits(other.bits), blocks(other.blocks), k(other.k), hash(other.hash) {
+            other.raw = nullptr;
+            other.bits = nullptr;
+            other.blocks = 0;
+            other.k = 0;
+        }
+        bloom_filter & operator=(bloom_filter &&other) noexcept {
+            if (this == &other) return *this;
+            swap(other);
+            return *this;
+        }
+        void swap(bloom_filter &other) noexcept {
+            std::swap(raw, other.raw);
+            std::swap(bits, other.bits);
+            std::swap(blocks, other.blocks);
+            std::swap(k, other.k);
+            std::swap(hash, other.hash);
+        }
+        ~bloom_filter() {
+            operator delete (raw);
+        }
+        /**
+         * size the filter for the given number of keys and false positive rate, dropping every key
+         */
+        void reset(size_t expected, double fpr) {
+            if (expected < 1) expected = 1;
+            if (fpr <= 0 || fpr >= 1) fpr = 0.01;
+            double per_key = -std::log(fpr) / (std::log(2.0) * std::log(2.0));
+            int n = (int) (per_key * std::log(2.0) + 0.5);
+            allocate((size_t) (expected * per_key) / (BLOCK_WORDS * 64) + 1);
+            k = n < 1 ? 1 : n > 16 ? 16 : n;
+        }
+        void clear() {
+            if (blocks > 0) memset(bits, 0, blocks * BLOCK_WORDS * sizeof(uint64_t));
+        }
+        void add(const Key &key) {
+            uint64_t h = mix(hash(key)), g = mix(h);
+            uint64_t *b = block(h);
+            uint32_t h1 = (uint32_t) g, h2 = (uint32_t) (g >> 32) | 1;
+            for (int i = 0; i < k; ++i, h1 += h2) b[(h1 >> 6) & 7] |= 1ULL << (h1 & 63);
+        }
+        bool may_contain(const Key &key) const {
+            uint64_t h = mix(hash(key)), g = mix(h);
+            const uint64_t *b = block(h);
+            uint32_t h1 = (uint32_t) g, h2 = (uint32_t) (g >> 32) | 1;
+            for (int i = 0; i < k; ++i, h1 += h2)
+                if ((b[(h1 >> 6) & 7] >> (h1 & 63) & 1) == 0) return false;
+            return true;
+        }
+    };
+
+    /**
+     * A map whose lookups of absent keys usually stop at the filter. Erasing leaves stale bits behind,
+     * which only costs false positives; rebuild() drops them. The filter is rebuilt for twice the
+     * capacity whenever the map outgrows it, so the false positive rate stays near the one requested.
+     * The map is a private base, so only the operations below can add keys, and all of them add them
+     * to the filter too.
+     */
+    template<
+            class Key,
+            class T,
+            class Compare = std::less<Key>,
+            class Hash = std::hash<Key>
+    > class bloom_map : private map<Key, T, Compare> {
+    public:
+        typedef map<Key, T, Compare> base;
+        typedef typename base::value_type value_type;
+        typedef typename base::iterator iterator;
+        typedef typename base::const_iterator const_iterator;
+        using base::begin;
+        using base::cbegin;
+        using base::end;
+        using base::cend;
+        using base::empty;
+        using base::size;
+        using base::erase;
+        using base::erase_if;
+        using base::split;
+        bloom_filter<Key, Hash> filter;
+        size_t capacity;
+        double fpr;
+
+        void grow() {
+            if (base::size() <= capacity) return;
+            capacity *= 2;
+            rebuild();
+        }
+        bloom_map(size_t expected = 1024, double rate = 0.01): filter(expected, rate), capacity(expected), fpr(rate) {
+            if (capacity < 1) capacity = 1;
+        }
+        bloom_map(const bloom_map &other) = default;
+        bloom_map & operator=(const bloom_map &other) = default;
+        /**
+         * other keeps no filter, so its next insertion rebuilds one
+         */
+        bloom_map(bloom_map &&other) noexcept: base(std::move(other)), filter(std::move(other.filter)), capacity(other.capacity), fpr(other.fpr) {
+            other.capacity = 0;
+        }
+        bloom_map & operator=(bloom_map &&other) noexcept {
+            if (this == &other) return *this;
+            base::operator=(std::move(other));
+            filter = std::move(other.filter);
+            capacity = other.capacity;
+            fpr = other.fpr;
+            other.capacity = 0;
+            return *this;
+        }
+        void swap(bloom_map &other) noexcept {
+            base::swap(other);
+            filter.swap(other.filter);
+            std::swap(capacity, other.capacity);
+            std::swap(fpr, other.fpr);
+        }
+        /**
+         * refill the filter from the keys still present
+         */
+        void rebuild() {
+            if (capacity < base::size()) capacity = base::size();
+            filter.reset(capacity, fpr);
+            for (const_iterator it = base::cbegin(); it != base::cend(); ++it) filter.add(it->first);
+        }
+        T & at(const Key &key) {
+            if (!filter.may_contain(key)) throw index_out_of_bound();
+            return base::at(key);
+        }
+        const T & at(const Key &key) const {
+            if (!filter.may_contain(key)) throw index_out_of_bound();
+            return base::at(key);
+        }
+        T & operator[](const Key &key) {
+            if (!filter.may_contain(key)) filter.add(key);
+            T &ret = base::operator[](key);
+            grow();
+            return ret;
+        }
+        const T & operator[](const Key &key) const {
+            return at(key);
+        }
+        void clear() {
+            base::clear();
+            filter.clear();
+        }
+        pair<iterator, bool> insert(const value_type &value) {
+            pair<iterator, bool> ret = base::insert(value);
+            if (ret.second) {
+                filter.add(value.first);
+                grow();
+            }
+            return ret;
+        }
+        size_t count(const Key &key) const {
+            if (!filter.may_contain(key)) return 0;
+            return base::count(key);
+        }
+        iterator find(const Key &key) {
+            if (!filter.may_contain(key)) return base::end();
+            return base::find(key);
+        }
+        const_iterator find(const Key &key) const {
+            if (!filter.may_contain(key)) return base::cend();
+            return base::find(key);
+        }
+    };
+
+    template<class Key, class T, class Compare, class Hash>
+    void swap(bloom_map<Key, T, Compare, Hash> &a, bloom_map<Key, T, Compare, Hash> &b) noexcept {
+        a.swap(b);
+    }
+
+}
+
+#endif
@@ -0,0 +1,518 @@
+/**
+ * implement a write-optimized container like std::map (log-structured merge of sorted runs)
+ */
+#ifndef SJTU_BUFFERED_MAP_HPP
+#define SJTU_BUFFERED_MAP_HPP
+
+#include <functional>
+#include <cstddef>
+#include <utility>
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+    /**
+     * New entries go to a small sorted buffer; a full buffer is merged with the
+     * levels below it like a binary counter, so level i holds at most BufferSize << i entries
+     * and every entry is moved O(log n) times. Erasing writes a tombstone which is
+     * dropped once it reaches the oldest level.
+     * Lower runs are newer: a lookup checks the buffer first and stops at the first match.
+     * Any insertion or erasure invalidates all iterators.
+     */
+    template<
+            class Key,
+            class T,
+            class Compare = std::less<Key>,
+            int BufferSize = 256
+    > class buffered_map {
+    public:
+        typedef pair<const Key, T> value_type;
+        struct entry {
+            value_type data;
+            bool dead;
+            entry(const value_type &val, bool d): data(val), dead(d) {}
+        };
+        struct run {
+            entry *data;
+            int len;
+            run(): data(nullptr), len(0) {}
+        };
+        static const int MAX_RUNS = 48;
+        /**
+         * runs[0] is the buffer, runs[i] is level i - 1
+         */
+        run runs[MAX_RUNS];
+        int used;
+        /**
+         * the number of live keys, known only while exact; put() leaves it stale and size() recounts
+         */
+        mutable size_t len;
+        mutable bool exact;
+        Compare com;
+
+        static entry *allocate(int n) {
+            return (entry*) (operator new (n * sizeof(entry)));
+        }
+        static void release(run &r) {
+            for (int i = 0; i < r.len; ++i) r.data[i].~entry();
+            operator delete (r.data);
+            r.data = nullptr;
+            r.len = 0;
+        }
+        int lower(const run &r, const Key &k) const {
+            int l = 0, h = r.len;
+            while (l < h) {
+                int mid = (l + h) >> 1;
+                if (com(r.data[mid].data.first, k)) l = mid + 1;
+                else h = mid;
+            }
+            return l;
+        }
+        int upper(const run &r, const Key &k) const {
+            int l = 0, h = r.len;
+            while (l < h) {
+                int mid = (l + h) >> 1;
+                if (com(k, r.data[mid].data.first)) h = mid;
+                else l = mid + 1;
+            }
+            return l;
+        }
+        /**
+         * newest entry with key k, live or not
+         */
+        bool search(const Key &k, int &c, int &i) const {
+            for (c = 0; c < used; ++c) {
+                if (runs[c].len == 0) continue;
+                i = lower(runs[c], k);
+                if (i < runs[c].len && !com(k, runs[c].data[i].data.first)) return true;
+            }
+            return false;
+        }
+        /**
+         * first live entry with key >= k (> k when strict), c = -1 if none
+         */
+        void seek(const Key &key, bool strict, int &c, int &i) const {
+            const Key *k = &key;
+            while (true) {
+                c = -1;
+                for (int r = 0; r < used; ++r) {
+                    int j = strict ? upper(runs[r], *k) : lower(runs[r], *k);
+                    if (j == runs[r].len) continue;
+                    if (c == -1 || com(runs[r].data[j].data.first, runs[c].data[i].data.first)) {
+                        c = r;
+                        i = j;
+                    }
+                }
+                if (c == -1) i = 0;
+                if (c == -1 || !runs[c].data[i].dead) return;
+                k = &runs[c].data[i].data.first;
+                strict = true;
+            }
+        }
+        /**
+         * last live entry with key < *k (any key when k is null), c = -1 if none
+         */
+        void seek_back(const Key *k, int &c, int &i) const {
+            while (true) {
+                c = -1;
+                for (int r = 0; r < used; ++r) {
+                    int j = (k == nullptr ? runs[r].len : lower(runs[r], *k)) - 1;
+                    if (j < 0) continue;
+                    if (c == -1 || com(runs[c].data[i].data.first, runs[r].data[j].data.first)) {
+                        c = r;
+                        i = j;
+                    }
+                }
+                if (c == -1 || !runs[c].data[i].dead) return;
+                k = &runs[c].data[i].data.first;
+            }
+        }
+        /**
+         * merge two runs, the entries of a win over equal keys in b; both inputs are released
+         */
+        run merge(run &a, run &b, bool purge) {
+            run ret;
+            ret.data = allocate(a.len + b.len);
+            int i = 0, j = 0;
+            while (i < a.len || j < b.len) {
+                entry *e;
+                if (j == b.len || (i < a.len && com(a.data[i].data.first, b.data[j].data.first))) e = a.data + i++;
+                else if (i == a.len || com(b.data[j].data.first, a.data[i].data.first)) e = b.data + j++;
+                else {
+                    e = a.data + i++;
+                    ++j;
+                }
+                if (purge && e->dead) continue;
+                new(ret.data + ret.len) entry(*e);
+                ++ret.len;
+            }
+            release(a);
+            release(b);
+            return ret;
+        }
+        /**
+         * push the buffer down into the first empty level, merging every full level on the way
+         */
+        void flush() {
+            run carry = runs[0];
+            runs[0] = run();
+            runs[0].data = allocate(BufferSize);
+            int j = 1;
+            while (j < used && runs[j].data != nullptr) ++j;
+            if (j == MAX_RUNS) throw runtime_error();
+            if (j == used) ++used;
+            bool oldest = true;
+            for (int r = j + 1; r < used; ++r)
+                if (runs[r].data != nullptr) oldest = false;
+            for (int r = 1; r < j; ++r) carry = merge(carry, runs[r], oldest && r == j - 1);
+            if (j == 1 && oldest) {
+                run empty;
+                carry = merge(carry, empty, true);
+            }
+            if (carry.len == 0) release(carry);
+            runs[j] = carry;
+        }
+        void copy(const buffered_map &other) {
+            used = other.used;
+            len = other.len;
+            exact = other.exact;
+            for (int r = 0; r < used; ++r) {
+                if (other.runs[r].data == nullptr) continue;
+                runs[r].data = allocate(r == 0 ? BufferSize : other.runs[r].len);
+                for (runs[r].len = 0; runs[r].len < other.runs[r].len; ++runs[r].len)
+                    new(runs[r].data + runs[r].len) entry(other.runs[r].data[runs[r].len]);
+            }
+        }
+        /**
+         * count the live keys by walking every run side by side, the newest entry of each key deciding
+         */
+        size_t count_live() const {
+            int pos[MAX_RUNS] = {};
+            size_t ret = 0;
+            while (true) {
+                int c = -1;
+                for (int r = 0; r < used; ++r)
+                    if (pos[r] < runs[r].len && (c == -1 || com(runs[r].data[pos[r]].data.first, runs[c].data[pos[c]].data.first))) c = r;
+                if (c == -1) return ret;
+                const Key &k = runs[c].data[pos[c]].data.first;
+                if (!runs[c].data[pos[c]].dead) ++ret;
+                for (int r = c + 1; r < used; ++r)
+                    if (pos[r] < runs[r].len && !com(k, runs[r].data[pos[r]].data.first)) ++pos[r];
+                ++pos[c];
+            }
+        }
+        /**
+         * write an entry into the buffer, replacing a buffered one with the same key
+         */
+        entry *put_entry(const value_type &value, bool dead) {
+            if (runs[0].data == nullptr) runs[0].data = allocate(BufferSize);
+            if (runs[0].len == BufferSize) flush();
+            run &b = runs[0];
+            int i = lower(b, value.first);
+            if (i < b.len && !com(value.first, b.data[i].data.first)) {
+                b.data[i].~entry();
+                return new(b.data + i) entry(value, dead);
+            }
+            for (int j = b.len; j > i; --j) {
+                new(b.data + j) entry(b.data[j - 1]);
+                b.data[j - 1].~entry();
+            }
+            ++b.len;
+            return new(b.data + i) entry(value, dead);
+        }
+        class const_iterator;
+        class iterator {
+        private:
+            friend const_iterator;
+        public:
+            int comp, index;
+            buffered_map *it;
+            iterator(int c = -1, int i = 0, buffered_map *obj = nullptr) {
+                comp = c;
+                index = i;
+                it = obj;
+            }
+            iterator operator++(int) {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+            iterator & operator++() {
+                if (comp == -1) throw invalid_iterator();
+                it->seek(it->runs[comp].data[index].data.first, true, comp, index);
+                return *this;
+            }
+            iterator operator--(int) {
+                iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+            iterator & operator--() {
+                int c, i;
+                it->seek_back(comp == -1 ? nullptr : &it->runs[comp].data[index].data.first, c, i);
+                if (c == -1) throw invalid_iterator();
+                comp = c;
+                index = i;
+                return *this;
+            }
+            value_type & operator*() const {
+                if (comp == -1) throw invalid_iterator();
+                return it->runs[comp].data[index].data;
+            }
+            value_type* operator->() const noexcept {
+                return &(it->runs[comp].data[index].data);
+            }
+            bool operator==(const iterator &rhs) const {
+                return comp == rhs.comp && index == rhs.index && it == rhs.it;
+            }
+            bool operator==(const const_iterator &rhs) const {
+                return comp == rhs.comp && index == rhs.index && it == rhs.it;
+            }
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+        class const_iterator {
+        private:
+            friend iterator;
+        public:
+            int comp, index;
+            const buffered_map *it;
+            const_iterator(int c = -1, int i = 0, const buffered_map *obj = nullptr) {
+                comp = c;
+                index = i;
+                it = obj;
+            }
+            const_iterator(const iterator &other) {
+                comp = other.comp;
+                index = other.index;
+                it = other.it;
+            }
+            const_iterator operator++(int) {
+                const_iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+            const_iterator & operator++() {
+                if (comp == -1) throw invalid_iterator();
+                it->seek(it->runs[comp].data[index].data.first, true, comp, index);
+                return *this;
+            }
+            const_iterator operator--(int) {
+                const_iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+            const_iterator & operator--() {
+                int c, i;
+                it->seek_back(comp == -1 ? nullptr : &it->runs[comp].data[index].data.first, c, i);
+                if (c == -1) throw invalid_iterator();
+                comp = c;
+                index = i;
+                return *this;
+            }
+            const value_type & operator*() const {
+                if (comp == -1) throw invalid_iterator();
+                return it->runs[comp].data[index].data;
+            }
+            const value_type* operator->() const noexcept {
+                return &(it->runs[comp].data[index].data);
+            }
+            bool operator==(const iterator &rhs) const {
+                return comp == rhs.comp && index == rhs.index && it == rhs.it;
+            }
+            bool operator==(const const_iterator &rhs) const {
+                return comp == rhs.comp && index == rhs.index && it == rhs.it;
+            }
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+        buffered_map() {
+            runs[0].data = allocate(BufferSize);
+            used = 1;
+            len = 0;
+            exact = true;
+        }
+        buffered_map(const buffered_map &other) {
+            copy(other);
+        }
+        buffered_map & operator=(const buffered_map &other) {
+            if (this == &other) return *this;
+            for (int r = 0; r < used; ++r) release(runs[r]);
+            copy(other);
+            return *this;
+        }
+        /**
+         * takes other's runs; other is left empty and gets a new buffer on its next write
+         */
+        buffered_map(buffered_map &&other) noexcept: used(other.used), len(other.len), exact(other.exact), com(other.com) {
+            for (int r = 0; r < used; ++r) {
+                runs[r] = other.runs[r];
+                other.runs[r] = run();
+            }
+            other.used = 1;
+            other.len = 0;
+            other.exact = true;
+        }
+        buffered_map & operator=(buffered_map &&other) noexcept {
+            if (this == &other) return *this;
+            for (int r = 0; r < used; ++r) release(runs[r]);
+            used = 1;
+            len = 0;
+            exact = true;
+            swap(other);
+            return *this;
+        }
+        void swap(buffered_map &other) noexcept {
+            int n = used > other.used ? used : other.used;
+            for (int r = 0; r < n; ++r) std::swap(runs[r], other.runs[r]);
+            std::swap(used, other.used);
+            std::swap(len, other.len);
+            std::swap(exact, other.exact);
+            std::swap(com, other.com);
+        }
+        ~buffered_map() {
+            for (int r = 0; r < used; ++r) release(runs[r]);
+        }
+        T & at(const Key &key) {
+            int c, i;
+            if (!search(key, c, i) || runs[c].data[i].dead) throw index_out_of_bound();
+            return runs[c].data[i].data.second;
+        }
+        const T & at(const Key &key) const {
+            int c, i;
+            if (!search(key, c, i) || runs[c].data[i].dead) throw index_out_of_bound();
+            return runs[c].data[i].data.second;
+        }
+        T & operator[](const Key &key) {
+            return insert(value_type(key, T())).first->second;
+        }
+        const T & operator[](const Key &key) const {
+            return at(key);
+        }
+        iterator begin() {
+            int c = -1, i = 0;
+            for (int r = 0; r < used; ++r)
+                if (runs[r].len > 0 && (c == -1 || com(runs[r].data[0].data.first, runs[c].data[0].data.first))) c = r;
+            if (c == -1) return end();
+            seek(runs[c].data[0].data.first, false, c, i);
+            return iterator(c, i, this);
+        }
+        const_iterator cbegin() const {
+            return const_cast<buffered_map*>(this)->begin();
+        }
+        iterator end() {
+            return iterator(-1, 0, this);
+        }
+        const_iterator cend() const {
+            return const_iterator(-1, 0, this);
+        }
+        bool empty() const {
+            return size() == 0;
+        }
+        /**
+         * after a put() this counts the keys in O(n) once, without moving any entry, so iterators stay valid
+         */
+        size_t size() const {
+            if (!exact) {
+                len = count_live();
+                exact = true;
+            }
+            return len;
+        }
+        void clear() {
+            for (int r = 0; r < used; ++r) release(runs[r]);
+            runs[0].data = allocate(BufferSize);
+            used = 1;
+            len = 0;
+            exact = true;
+        }
+        pair<iterator, bool> insert(const value_type &value) {
+            int c, i;
+            if (search(value.first, c, i) && !runs[c].data[i].dead)
+                return pair<iterator, bool>(iterator(c, i, this), false);
+            entry *e = put_entry(value, false);
+            ++len;
+            return pair<iterator, bool>(iterator(0, e - runs[0].data, this), true);
+        }
+        /**
+         * insert or overwrite without looking at the older runs: the write-optimized path
+         */
+        void put(const value_type &value) {
+            put_entry(value, false);
+            exact = false;
+        }
+        void erase(iterator pos) {
+            if (pos.it != this || pos.comp == -1) throw index_out_of_bound();
+            entry &e = runs[pos.comp].data[pos.index];
+            if (e.dead) throw invalid_iterator();
+            if (pos.comp == 0) e.dead = true;
+            else {
+                value_type tomb(e.data);
+                put_entry(tomb, true);
+            }
+            --len;
+        }
+        /**
+         * merge the buffer and every level into a single run without tombstones
+         */
+        void compact() {
+            run carry = runs[0];
+            runs[0] = run();
+            runs[0].data = allocate(BufferSize);
+            for (int r = 1; r < used; ++r) carry = merge(carry, runs[r], false);
+            run empty;
+            carry = merge(carry, empty, true);
+            len = carry.len;
+            exact = true;
+            if (carry.len == 0) {
+                release(carry);
+                used = 1;
+                return;
+            }
+            int j = 1;
+            while (j < MAX_RUNS - 1 && ((size_t) BufferSize << (j - 1)) < (size_t) carry.len) ++j;
+            runs[j] = carry;
+            used = j + 1;
+        }
+        size_t count(const Key &key) const {
+            int c, i;
+            return search(key, c, i) && !runs[c].data[i].dead ? 1 : 0;
+        }
+        iterator find(const Key &key) {
+            int c, i;
+            if (!search(key, c, i) || runs[c].data[i].dead) return end();
+            return iterator(c, i, this);
+        }
+        const_iterator find(const Key &key) const {
+            int c, i;
+            if (!search(key, c, i) || runs[c].data[i].dead) return cend();
+            return const_iterator(c, i, this);
+        }
+        iterator lower_bound(const Key &key) {
+            int c, i = 0;
+            seek(key, false, c, i);
+            if (c == -1) return end();
+            return iterator(c, i, this);
+        }
+        const_iterator lower_bound(const Key &key) const {
+            return const_cast<buffered_map*>(this)->lower_bound(key);
+        }
+    };
+
+    template<class Key, class T, class Compare, int BufferSize>
+    void swap(buffered_map<Key, T, Compare, BufferSize> &a, buffered_map<Key, T, Compare, BufferSize> &b) noexcept {
+        a.swap(b);
+    }
+
+}
+
+#endif
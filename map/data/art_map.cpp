@@ -0,0 +1,109 @@
+#include<iostream>
+#include<map>
+#include<string>
+#include<cstdio>
+#include<cstdlib>
+#include<new>
+#include<vector>
+#include "art_map.hpp"
+
+using namespace std;
+
+long long allocations = 0;
+
+void *operator new(size_t n){
+	++allocations;
+	void *p = malloc(n ? n : 1);
+	if(p == nullptr) throw std::bad_alloc();
+	return p;
+}
+void operator delete(void *p) noexcept{
+	free(p);
+}
+void operator delete(void *p, size_t) noexcept{
+	free(p);
+}
+
+template<class Map, class StdMap>
+bool same(Map &Q, StdMap &stdQ){
+	if(Q.size() != stdQ.size()) return 0;
+	typename StdMap::iterator stdit = stdQ.begin();
+	for(typename Map::iterator it = Q.begin(); it != Q.end(); it++, stdit++)
+		if(stdit == stdQ.end() || it -> first != stdit -> first || it -> second != stdit -> second) return 0;
+	if(stdit != stdQ.end()) return 0;
+	if(stdQ.empty()) return 1;
+	stdit = --stdQ.end();
+	for(typename Map::iterator it = --Q.end(); it != Q.begin(); it--, stdit--)
+		if(it -> first != stdit -> first) return 0;
+	return 1;
+}
+
+template<class Map, class StdMap, class Gen>
+bool random_test(Gen gen){
+	Map Q;
+	StdMap stdQ;
+	for(int i = 1; i <= 200000; i++){
+		int op = rand() % 4;
+		typename StdMap::key_type k = gen();
+		if(op < 2){
+			if(Q.insert(typename Map::value_type(k, i)).second != stdQ.insert(typename StdMap::value_type(k, i)).second) return 0;
+		}
+		else if(op == 2){
+			typename Map::iterator it = Q.find(k);
+			if((it == Q.end()) != (stdQ.count(k) == 0)) return 0;
+			if(it != Q.end()){
+				Q.erase(it);
+				stdQ.erase(k);
+			}
+		}
+		else{
+			typename Map::iterator it = Q.lower_bound(k);
+			typename StdMap::iterator stdit = stdQ.lower_bound(k);
+			if((it == Q.end()) != (stdit == stdQ.end())) return 0;
+			if(stdit != stdQ.end() && it -> first != stdit -> first) return 0;
+		}
+		if(i % 20000 == 0 && !same(Q, stdQ)) return 0;
+	}
+	Map P(Q);
+	if(!same(P, stdQ)) return 0;
+	while(!Q.empty()) Q.erase(Q.begin());
+	return Q.root == nullptr;
+}
+
+int small_int(){
+	return rand() % 3000 - 1500;
+}
+
+int big_int(){
+	return rand() - RAND_MAX / 2;
+}
+
+string str(){
+	string s;
+	if(rand() % 5 == 0) s = string(rand() % 30, 'q');
+	for(int l = rand() % 14; l > 0; l--) s += "ab\xff\0xyz"[rand() % 7];
+	return s;
+}
+
+bool check4(){ //looking up keys longer than the small-string buffer allocates nothing
+	sjtu::art_map<string, int> Q;
+	vector<string> keys;
+	for(int i = 0; i < 10000; i++) keys.push_back(string(40, 'k') + to_string(i * 7919 % 10007));
+	for(int i = 0; i < 10000; i++) Q[keys[i]] = i;
+	allocations = 0;
+	long long sum = 0;
+	for(int i = 0; i < 10000; i++){
+		sum += Q.at(keys[i]) + (int) Q.count(keys[i]);
+		if(Q.find(keys[i]) == Q.end() || Q.lower_bound(keys[i]) -> second != i) return 0;
+	}
+	Q.erase(Q.find(keys[0]));
+	return allocations == 0 && sum == 10000LL * 9999 / 2 + 10000 && Q.size() == 9999;
+}
+
+int main(){
+	if(!random_test<sjtu::art_map<int, int>, std::map<int, int> >(small_int)) cout << "Test 1 Failed......" << endl; else cout << "Test 1 Passed!" << endl;
+	if(!random_test<sjtu::art_map<int, int>, std::map<int, int> >(big_int)) cout << "Test 2 Failed......" << endl; else cout << "Test 2 Passed!" << endl;
+	if(!random_test<sjtu::art_map<string, int>, std::map<string, int> >(str)) cout << "Test 3 Failed......" << endl; else cout << "Test 3 Passed!" << endl;
+	if(!check4()) cout << "Test 4 Failed......" << endl; else cout << "Test 4 Passed!" << endl;
+	return 0;
+}
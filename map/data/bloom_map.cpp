@@ -0,0 +1,103 @@
+#include<iostream>
+#include<map>
+#include<ctime>
+#include<cstdio>
+#include<cstdlib>
+#include<type_traits>
+#include<new>
+#include "bloom_map.hpp"
+
+using namespace std;
+
+size_t fail_from = (size_t) -1; //allocations of at least this many bytes throw
+
+void *operator new(size_t n){
+	if(n >= fail_from) throw std::bad_alloc();
+	void *p = malloc(n ? n : 1);
+	if(p == nullptr) throw std::bad_alloc();
+	return p;
+}
+void operator delete(void *p) noexcept{
+	free(p);
+}
+void operator delete(void *p, size_t) noexcept{
+	free(p);
+}
+
+typedef sjtu::bloom_map<int, int> BMap;
+
+bool check1(){ //same answers as std::map under insert & erase
+	BMap Q(16, 0.01);
+	std::map<int, int> stdQ;
+	for(int i = 1; i <= 200000; i++){
+		int op = rand() % 4, k = rand() % 50000;
+		if(op == 0) Q[k] = i, stdQ[k] = i;
+		else if(op == 1){
+			if(Q.insert(BMap::value_type(k, i)).second != stdQ.insert(std::map<int, int>::value_type(k, i)).second) return 0;
+		}
+		else if(op == 2){
+			BMap::iterator it = Q.find(k);
+			if((it == Q.end()) != (stdQ.count(k) == 0)) return 0;
+			if(it != Q.end()){
+				Q.erase(it);
+				stdQ.erase(k);
+			}
+		}
+		else if(Q.count(k) != stdQ.count(k)) return 0;
+		if(i % 50000 == 0) Q.rebuild();
+	}
+	BMap P(Q);
+	for(std::map<int, int>::iterator it = stdQ.begin(); it != stdQ.end(); it++)
+		if(P.at(it -> first) != it -> second) return 0;
+	return Q.size() == stdQ.size();
+}
+
+bool check2(){ //false positive rate stays near the requested one
+	BMap Q(1000, 0.01);
+	for(int i = 0; i < 100000; i++) Q[i * 2] = i;
+	int fp = 0;
+	for(int i = 0; i < 100000; i++) fp += Q.filter.may_contain(i * 2 + 1);
+	printf("false positive rate %.4f ", fp / 100000.0);
+	return fp < 3000;
+}
+
+bool check3(){ //range erase and erase_if reach the map through bloom_map, other ways in to the map do not
+	static_assert(!std::is_convertible<BMap*, sjtu::map<int, int>*>::value, "the map must not be reachable around the filter");
+	BMap Q(16, 0.01);
+	for(int i = 0; i < 10000; i++) Q[i * 3] = i;
+	if(Q.size() != 10000) return 0;
+	Q.erase(Q.find(300), Q.find(600));
+	Q.erase_if([](const BMap::value_type &x){ return x.first % 2 == 0; });
+	for(int i = 0; i < 10000; i++){
+		int k = i * 3;
+		if(Q.count(k) != (k % 2 != 0 && (k < 300 || k >= 600))) return 0;
+		if(Q.count(k) && Q.at(k) != i) return 0;
+	}
+	Q[4] = 4;
+	return Q.count(4) == 1 && Q.find(4) != Q.end();
+}
+
+bool check4(){ //a filter whose new bits cannot be allocated keeps its old ones
+	typedef sjtu::bloom_filter<int> Filter;
+	Filter big(1000000, 0.01), small(10, 0.01);
+	big.add(1);
+	small.add(2);
+	fail_from = 1 << 16;
+	bool thrown = false;
+	try{ small = big; }
+	catch(std::bad_alloc &){ thrown = true; }
+	try{ small.reset(1000000, 0.01); thrown = false; }
+	catch(std::bad_alloc &){}
+	fail_from = (size_t) -1;
+	if(!thrown || !small.may_contain(2)) return 0;
+	small = big;
+	return small.may_contain(1) && small.blocks == big.blocks;
+}
+
+int main(){
+	if(!check1()) cout << "Test 1 Failed......" << endl; else cout << "Test 1 Passed!" << endl;
+	if(!check2()) cout << "Test 2 Failed......" << endl; else cout << "Test 2 Passed!" << endl;
+	if(!check3()) cout << "Test 3 Failed......" << endl; else cout << "Test 3 Passed!" << endl;
+	if(!check4()) cout << "Test 4 Failed......" << endl; else cout << "Test 4 Passed!" << endl;
+	return 0;
+}
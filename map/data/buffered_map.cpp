@@ -0,0 +1,99 @@
+#include<iostream>
+#include<map>
+#include<cstdio>
+#include<cstdlib>
+#include "buffered_map.hpp"
+
+using namespace std;
+
+typedef sjtu::buffered_map<int, int, std::less<int>, 16> BMap;
+
+bool same(BMap &Q, std::map<int, int> &stdQ){
+	if(Q.size() != stdQ.size()) return 0;
+	std::map<int, int>::iterator stdit = stdQ.begin();
+	for(BMap::iterator it = Q.begin(); it != Q.end(); it++, stdit++)
+		if(stdit == stdQ.end() || it -> first != stdit -> first || it -> second != stdit -> second) return 0;
+	if(stdit != stdQ.end()) return 0;
+	if(stdQ.empty()) return 1;
+	stdit = --stdQ.end();
+	for(BMap::iterator it = --Q.end(); it != Q.begin(); it--, stdit--)
+		if(it -> first != stdit -> first) return 0;
+	return 1;
+}
+
+bool check1(){ //insert, put & erase against std::map
+	BMap Q;
+	std::map<int, int> stdQ;
+	for(int i = 1; i <= 100000; i++){
+		int op = rand() % 5, k = rand() % 3000;
+		if(op < 2){
+			if(Q.insert(BMap::value_type(k, i)).second != stdQ.insert(std::map<int, int>::value_type(k, i)).second) return 0;
+		}
+		else if(op == 2){
+			Q.put(BMap::value_type(k, i));
+			stdQ[k] = i;
+		}
+		else if(op == 3){
+			BMap::iterator it = Q.find(k);
+			if((it == Q.end()) != (stdQ.count(k) == 0)) return 0;
+			if(it != Q.end()){
+				if(it -> second != stdQ[k]) return 0;
+				Q.erase(it);
+				stdQ.erase(k);
+			}
+		}
+		else if(i % 1000 == 0){
+			if(!same(Q, stdQ)) return 0;
+			int k = rand() % 3100;
+			BMap::iterator it = Q.lower_bound(k);
+			std::map<int, int>::iterator stdit = stdQ.lower_bound(k);
+			if((it == Q.end()) != (stdit == stdQ.end())) return 0;
+			if(stdit != stdQ.end() && it -> first != stdit -> first) return 0;
+		}
+	}
+	return same(Q, stdQ);
+}
+
+bool check2(){ //copy, [] & compact
+	BMap Q;
+	std::map<int, int> stdQ;
+	for(int i = 1; i <= 5000; i++){
+		int k = rand() % 2000;
+		Q[k] += i;
+		stdQ[k] += i;
+	}
+	BMap P(Q);
+	Q.clear();
+	if(!Q.empty() || !same(P, stdQ)) return 0;
+	Q = P;
+	Q.compact();
+	return same(Q, stdQ) && Q.at(stdQ.begin() -> first) == stdQ.begin() -> second;
+}
+
+bool check3(){ //size after put keeps iterators valid and works on a const copy
+	BMap Q;
+	std::map<int, int> stdQ;
+	for(int i = 1; i <= 3000; i++){
+		int k = rand() % 1000;
+		if(i % 3 == 0){
+			BMap::iterator it = Q.find(k);
+			if(it != Q.end()) Q.erase(it), stdQ.erase(k);
+		}
+		else Q.put(BMap::value_type(k, i)), stdQ[k] = i;
+	}
+	BMap::iterator it = Q.begin();
+	BMap::value_type *first = &*it;
+	if(Q.size() != stdQ.size() || &*it != first || it -> first != stdQ.begin() -> first) return 0;
+	Q.put(BMap::value_type(-1, 0));
+	stdQ[-1] = 0;
+	const BMap P(Q);
+	if(P.size() != stdQ.size() || P.empty()) return 0;
+	return same(Q, stdQ);
+}
+
+int main(){
+	if(!check1()) cout << "Test 1 Failed......" << endl; else cout << "Test 1 Passed!" << endl;
+	if(!check2()) cout << "Test 2 Failed......" << endl; else cout << "Test 2 Passed!" << endl;
+	if(!check3()) cout << "Test 3 Failed......" << endl; else cout << "Test 3 Passed!" << endl;
+	return 0;
+}
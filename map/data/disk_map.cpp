@@ -0,0 +1,148 @@
+#include<iostream>
+#include<map>
+#include<cstdio>
+#include<cstdlib>
+#include<unistd.h>
+#include<csignal>
+#include<sys/resource.h>
+#include "disk_map.hpp"
+
+using namespace std;
+
+const char *FILE_NAME = "disk_map.db";
+typedef sjtu::disk_map<int, long long, std::less<int>, 256> DMap;
+
+std::map<int, long long> stdQ;
+
+bool check1(){ //random insert & erase against std::map
+	unlink(FILE_NAME);
+	DMap Q(FILE_NAME);
+	for(int i = 1; i <= 200000; i++){
+		int op = rand() % 3, k = rand() % 50000;
+		if(op < 2){
+			bool a = Q.insert(DMap::value_type(k, i)).second;
+			bool b = stdQ.insert(std::map<int, long long>::value_type(k, i)).second;
+			if(a != b) return 0;
+		}
+		else{
+			DMap::iterator it = Q.find(k);
+			if((it == Q.end()) != (stdQ.count(k) == 0)) return 0;
+			if(it != Q.end()){
+				Q.erase(it);
+				stdQ.erase(k);
+			}
+		}
+	}
+	Q.flush();
+	return Q.size() == stdQ.size();
+}
+
+bool check2(){ //reopen & iterate both ways
+	DMap Q(FILE_NAME);
+	if(Q.size() != stdQ.size()) return 0;
+	std::map<int, long long>::iterator stdit = stdQ.begin();
+	for(DMap::iterator it = Q.begin(); it != Q.end(); it++, stdit++)
+		if(it -> first != stdit -> first || it -> second != stdit -> second) return 0;
+	stdit = --stdQ.end();
+	for(DMap::iterator it = --Q.end(); it != Q.begin(); it--, stdit--)
+		if(it -> first != stdit -> first) return 0;
+	return 1;
+}
+
+bool check3(){ //lower_bound
+	DMap Q(FILE_NAME);
+	for(int k = -5; k <= 50005; k += 7){
+		DMap::iterator it = Q.lower_bound(k);
+		std::map<int, long long>::iterator stdit = stdQ.lower_bound(k);
+		if((it == Q.end()) != (stdit == stdQ.end())) return 0;
+		if(stdit != stdQ.end() && it -> first != stdit -> first) return 0;
+	}
+	return 1;
+}
+
+bool check4(){ //erase all, [] & clear
+	DMap Q(FILE_NAME);
+	while(!Q.empty()) Q.erase(Q.begin());
+	if(Q.begin() != Q.end()) return 0;
+	Q[3] = 4;
+	if(Q.at(3) != 4 || Q.size() != 1) return 0;
+	Q.clear();
+	bool ok = Q.empty() && Q.count(3) == 0;
+	unlink(FILE_NAME);
+	return ok;
+}
+
+int lowest_fd(){
+	int fd = dup(0);
+	close(fd);
+	return fd;
+}
+
+bool check5(){ //a file that cannot grow: opening fails without leaking the fd, growing fails and leaves the map usable
+	signal(SIGXFSZ, SIG_IGN);
+	struct rlimit old, lim;
+	getrlimit(RLIMIT_FSIZE, &old);
+	lim = old;
+	lim.rlim_cur = 16 * 256 + 100;
+	int before = lowest_fd();
+	bool ok = 1;
+	setrlimit(RLIMIT_FSIZE, &lim);
+	for(int i = 0; i < 3; i++){
+		lim.rlim_cur = 100;
+		setrlimit(RLIMIT_FSIZE, &lim);
+		try{ DMap Q(FILE_NAME); ok = 0; }
+		catch(sjtu::runtime_error &){}
+		unlink(FILE_NAME);
+	}
+	if(lowest_fd() != before) ok = 0;
+	lim.rlim_cur = 16 * 256 + 100;
+	setrlimit(RLIMIT_FSIZE, &lim);
+	{
+		DMap Q(FILE_NAME);
+		int n = 0;
+		try{
+			for(; n < 100000; n++) Q[n] = n;
+			ok = 0;
+		}
+		catch(sjtu::runtime_error &){}
+		for(int i = 0; i < n; i++) if(Q.count(i) != 1 || Q.at(i) != i) ok = 0;
+		Q.erase(Q.find(0));
+		if(Q.count(0) != 0) ok = 0;
+	}
+	setrlimit(RLIMIT_FSIZE, &old);
+	unlink(FILE_NAME);
+	return ok && lowest_fd() == before;
+}
+
+bool check6(){ //flush covers pages written through iterators and more pages than the dirty list holds
+	unlink(FILE_NAME);
+	bool ok = 1;
+	{
+		DMap Q(FILE_NAME);
+		for(int i = 0; i < 20000; i++) Q[i] = i;
+		Q.flush();
+		DMap::iterator it = Q.find(5);
+		it -> second = -5;
+		if(Q.ndirty == 0 && !Q.lost) ok = 0;
+		Q.flush();
+		for(it = Q.begin(); it != Q.end(); it++) (*it).second *= 2;
+		if(!Q.lost) ok = 0;
+		Q.flush();
+		if(Q.lost || Q.ndirty != 0) ok = 0;
+	}
+	DMap Q(FILE_NAME);
+	for(int i = 0; i < 20000; i++) if(Q.at(i) != (i == 5 ? -10 : 2 * i)) ok = 0;
+	Q.clear();
+	unlink(FILE_NAME);
+	return ok && Q.size() == 0;
+}
+
+int main(){
+	if(!check1()) cout << "Test 1 Failed......" << endl; else cout << "Test 1 Passed!" << endl;
+	if(!check2()) cout << "Test 2 Failed......" << endl; else cout << "Test 2 Passed!" << endl;
+	if(!check3()) cout << "Test 3 Failed......" << endl; else cout << "Test 3 Passed!" << endl;
+	if(!check4()) cout << "Test 4 Failed......" << endl; else cout << "Test 4 Passed!" << endl;
+	if(!check5()) cout << "Test 5 Failed......" << endl; else cout << "Test 5 Passed!" << endl;
+	if(!check6()) cout << "Test 6 Failed......" << endl; else cout << "Test 6 Passed!" << endl;
+	return 0;
+}
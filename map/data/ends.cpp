@@ -0,0 +1,69 @@
+#include<iostream>
+#include<map>
+#include<ctime>
+#include<cstdio>
+#include<cstdlib>
+#include "map1.hpp"
+
+using namespace std;
+
+template<class Map>
+bool check_ends(){ //begin() and --end() track the smallest and largest keys through every kind of update
+	Map Q;
+	std::map<int, int> stdQ;
+	for(int i = 1; i <= 200000; i++){
+		int op = rand() % 6, k = rand() % 5000;
+		if(op == 0) Q[k] = i, stdQ[k] = i;
+		else if(op == 1) Q.insert(typename Map::value_type(k, i)), stdQ.insert(std::map<int, int>::value_type(k, i));
+		else if(op == 2) Q.erase(k), stdQ.erase(k);
+		else if(op == 3 && !stdQ.empty()){
+			if(rand() % 2) Q.erase(Q.begin()), stdQ.erase(stdQ.begin());
+			else Q.erase(--Q.end()), stdQ.erase(--stdQ.end());
+		}
+		else if(op == 4 && i % 100 == 0){
+			typename Map::iterator first = Q.find(k), last = Q.find(k + 100);
+			if(first != Q.end()){
+				Q.erase(first, last);
+				stdQ.erase(stdQ.find(k), last == Q.end() ? stdQ.end() : stdQ.find(k + 100));
+			}
+		}
+		else if(op == 5 && i % 5000 == 0){
+			Q.erase_if([&](const typename Map::value_type &v){ return v.second % 2 == 0; });
+			for(std::map<int, int>::iterator it = stdQ.begin(); it != stdQ.end(); )
+				if(it -> second % 2 == 0) stdQ.erase(it++); else ++it;
+		}
+		if(Q.size() != stdQ.size()) return 0;
+		if(stdQ.empty()){
+			if(Q.begin() != Q.end()) return 0;
+			continue;
+		}
+		if(Q.begin() -> first != stdQ.begin() -> first) return 0;
+		if((--Q.end()) -> first != (--stdQ.end()) -> first) return 0;
+		if(i % 20000 == 0){
+			Map P(Q);
+			if(P.cbegin() -> first != stdQ.begin() -> first || (--P.cend()) -> first != (--stdQ.end()) -> first) return 0;
+		}
+	}
+	Q.clear();
+	return Q.begin() == Q.end();
+}
+
+bool check1(){
+	return check_ends<sjtu::map<int, int> >() && check_ends<sjtu::map<int, int, std::less<int>, true> >();
+}
+
+bool check2(){ //a loop calling begin() and --end() each round no longer walks the tree
+	sjtu::map<int, int> Q;
+	for(int i = 0; i < 1000000; i++) Q[rand()] = i;
+	clock_t t0 = clock();
+	long long sum = 0;
+	for(int i = 0; i < 10000000; i++) sum += Q.begin() -> second + (--Q.end()) -> second;
+	printf("10^7 begin()/--end() pairs: %.3fs (%lld) ", (double) (clock() - t0) / CLOCKS_PER_SEC, sum);
+	return 1;
+}
+
+int main(){
+	if(!check1()) cout << "Test 1 Failed......" << endl; else cout << "Test 1 Passed!" << endl;
+	if(!check2()) cout << "Test 2 Failed......" << endl; else cout << "Test 2 Passed!" << endl;
+	return 0;
+}
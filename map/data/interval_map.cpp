@@ -0,0 +1,91 @@
+#include<iostream>
+#include<vector>
+#include<cstdio>
+#include<cstdlib>
+#include<algorithm>
+#include "interval_map.hpp"
+
+using namespace std;
+
+typedef sjtu::interval_map<int, int> IMap;
+
+struct Brute{
+	int lo, hi, val;
+};
+vector<Brute> all;
+
+int height(IMap::node *t){
+	if(t == nullptr) return 0;
+	return 1 + max(height(t -> left), height(t -> right));
+}
+
+bool valid(IMap::node *t, IMap::node *f, int &mx){
+	if(t == nullptr) return 1;
+	if(t -> father != f) return 0;
+	int l = -1, r = -1;
+	if(!valid(t -> left, t, l) || !valid(t -> right, t, r)) return 0;
+	mx = max(t -> data.first.second, max(l, r));
+	return mx == t -> max;
+}
+
+bool query(IMap &Q, int lo, int hi){
+	vector<int> got, want;
+	Q.overlap(lo, hi, [&](IMap::value_type &v){ got.push_back(v.second); });
+	for(size_t i = 0; i < all.size(); i++)
+		if(all[i].lo <= hi && lo <= all[i].hi) want.push_back(all[i].val);
+	sort(want.begin(), want.end());
+	sort(got.begin(), got.end());
+	return got == want;
+}
+
+bool check1(){ //random insert, erase & overlap queries
+	IMap Q;
+	for(int i = 1; i <= 20000; i++){
+		int op = rand() % 4;
+		if(op < 2){
+			int lo = rand() % 100000, hi = lo + rand() % 2000;
+			if(Q.insert(IMap::value_type(IMap::interval_type(lo, hi), i)).second)
+				all.push_back((Brute){lo, hi, i});
+		}
+		else if(op == 2 && !all.empty()){
+			int k = rand() % all.size();
+			IMap::iterator it = Q.find(IMap::interval_type(all[k].lo, all[k].hi));
+			if(it == Q.end() || it -> second != all[k].val) return 0;
+			Q.erase(it);
+			all.erase(all.begin() + k);
+		}
+		else if(i % 10 == 0){
+			int lo = rand() % 100000;
+			if(!query(Q, lo, lo + rand() % 100)) return 0;
+		}
+	}
+	int mx = -1;
+	return Q.size() == all.size() && valid(Q.root, nullptr, mx) && height(Q.root) < 40;
+}
+
+bool check2(){ //bulk construction & stabbing
+	vector<IMap::value_type> v;
+	all.clear();
+	for(int i = 0; i < 100000; i++){
+		v.push_back(IMap::value_type(IMap::interval_type(i * 10, i * 10 + rand() % 50), i));
+		all.push_back((Brute){i * 10, v.back().first.second, i});
+	}
+	IMap Q(v.begin(), v.end());
+	int mx = -1;
+	if(Q.size() != v.size() || !valid(Q.root, nullptr, mx) || height(Q.root) > 17) return 0;
+	for(int i = 0; i < 100; i++){
+		int x = rand() % 1000000, cnt = 0;
+		Q.stab(x, [&](IMap::value_type &){ cnt++; });
+		int want = 0;
+		for(size_t j = 0; j < all.size(); j++) if(all[j].lo <= x && x <= all[j].hi) want++;
+		if(cnt != want) return 0;
+	}
+	IMap P(Q);
+	return P.size() == Q.size() && P.begin() -> second == 0;
+}
+
+int main(){
+	if(!check1()) cout << "Test 1 Failed......" << endl; else cout << "Test 1 Passed!" << endl;
+	if(!check2()) cout << "Test 2 Failed......" << endl; else cout << "Test 2 Passed!" << endl;
+	return 0;
+}
@@ -0,0 +1,108 @@
+#include<iostream>
+#include<list>
+#include<map>
+#include<string>
+#include<cstdio>
+#include<cstdlib>
+#include<ctime>
+#include "lru_cache.hpp"
+
+using namespace std;
+
+typedef sjtu::lru_cache<int, int> Cache;
+
+bool check1(){ //same contents and evictions as a std::list + std::map model
+	Cache Q(100);
+	std::list<pair<int, int> > order;
+	std::map<int, std::list<pair<int, int> >::iterator> pos;
+	int evicted = -1, evictions = 0;
+	Q.set_evict_callback([&](const int &k, int &){ evicted = k; ++evictions; });
+	size_t hit = 0, miss = 0;
+	for(int i = 1; i <= 200000; i++){
+		int op = rand() % 3, k = rand() % 300;
+		if(op == 0){
+			int *v = Q.get(k);
+			if((v == nullptr) != (pos.count(k) == 0)) return 0;
+			if(v == nullptr){ ++miss; continue; }
+			++hit;
+			if(*v != pos[k] -> second) return 0;
+			order.splice(order.begin(), order, pos[k]);
+		}
+		else if(op == 1){
+			evicted = -1;
+			Q.put(k, i);
+			if(pos.count(k)){
+				pos[k] -> second = i;
+				order.splice(order.begin(), order, pos[k]);
+				if(evicted != -1) return 0;
+			}
+			else{
+				if(order.size() == 100){
+					if(evicted != order.back().first) return 0;
+					pos.erase(order.back().first);
+					order.pop_back();
+				}
+				else if(evicted != -1) return 0;
+				order.push_front(make_pair(k, i));
+				pos[k] = order.begin();
+			}
+		}
+		else if(rand() % 10 == 0){
+			if(Q.erase(k) != (pos.count(k) != 0)) return 0;
+			if(pos.count(k)){
+				order.erase(pos[k]);
+				pos.erase(k);
+			}
+		}
+		if(Q.size() != order.size()) return 0;
+	}
+	return Q.hits() == hit && Q.misses() == miss && evictions > 0;
+}
+
+bool check2(){ //peek, copies and shrinking the capacity
+	sjtu::lru_cache<string, int> Q(3);
+	Q.put("a", 1); Q.put("b", 2); Q.put("c", 3);
+	if(*Q.get("a") != 1) return 0;
+	Q.put("d", 4); //b is the least recently used
+	if(Q.contains("b") || !Q.contains("a")) return 0;
+	if(*Q.peek("c") != 3) return 0;
+	Q.put("e", 5); //peek did not refresh c
+	if(Q.contains("c")) return 0;
+	sjtu::lru_cache<string, int> P(Q);
+	P.set_capacity(1); //keeps only e
+	if(P.size() != 1 || !P.contains("e")) return 0;
+	if(Q.size() != 3 || Q.get("b") != nullptr) return 0;
+	Q.put("a", 10);
+	Q.set_capacity(2); //drops d
+	if(Q.contains("d") || *Q.get("a") != 10 || *Q.get("e") != 5) return 0;
+	P = Q;
+	Q.clear();
+	return Q.empty() && P.size() == 2 && P.hits() == Q.hits();
+}
+
+double ordered(size_t cap, bool &ok){ //200000 puts of increasing keys, each followed by a get of a recent key
+	sjtu::lru_cache<int, int> Q(cap);
+	clock_t t = clock();
+	for(int i = 0; i < 200000; i++){
+		Q.put(i, -i);
+		int k = i - (int) (rand() % 50); //the last 50 keys are always among the 100 most recently used
+		int *v = Q.get(k < 0 ? 0 : k);
+		if(v == nullptr || *v != -(k < 0 ? 0 : k)) ok = 0;
+	}
+	if(Q.size() != cap) ok = 0;
+	return (double) (clock() - t) / CLOCKS_PER_SEC;
+}
+
+bool check3(){ //keys in order cost about the same whatever the capacity
+	bool ok = 1;
+	double small = ordered(100, ok), large = ordered(100000, ok);
+	printf("ordered keys: capacity 100 %.3fs, capacity 100000 %.3fs ", small, large);
+	return ok && large < 10 * small + 0.05;
+}
+
+int main(){
+	if(!check1()) cout << "Test 1 Failed......" << endl; else cout << "Test 1 Passed!" << endl;
+	if(!check2()) cout << "Test 2 Failed......" << endl; else cout << "Test 2 Passed!" << endl;
+	if(!check3()) cout << "Test 3 Failed......" << endl; else cout << "Test 3 Passed!" << endl;
+	return 0;
+}
@@ -0,0 +1,86 @@
+#include "map1.hpp"
+#include "art_map.hpp"
+#include "bloom_map.hpp"
+#include "buffered_map.hpp"
+#include "interval_map.hpp"
+#include "lru_cache.hpp"
+#include "versioned_map.hpp"
+
+#include <iostream>
+#include <string>
+#include <utility>
+
+template<class M>
+void fill(M &m, int from, int n) {
+	for (int i = from; i < from + n; ++i) m.insert(typename M::value_type(i, std::to_string(i)));
+}
+
+template<class M>
+bool holds(const M &m, int from, int n) {
+	if (m.size() != (size_t) n) return false;
+	for (int i = from - 5; i < from + n + 5; ++i) if (m.count(i) != (i >= from && i < from + n)) return false;
+	return true;
+}
+
+template<class M>
+bool moves() { //the elements follow the move, the source is left empty and usable, swap exchanges
+	M a;
+	fill(a, 0, 3000);
+	M b(std::move(a));
+	if (!holds(b, 0, 3000) || !holds(a, 0, 0)) return false;
+	fill(a, 5000, 10);
+	M c;
+	fill(c, 100, 100);
+	c = std::move(b);
+	if (!holds(c, 0, 3000) || !holds(b, 0, 0)) return false;
+	fill(b, 7, 7);
+	swap(b, c);
+	if (!holds(b, 0, 3000) || !holds(c, 7, 7) || !holds(a, 5000, 10)) return false;
+	a = std::move(a);
+	M d(b);
+	b.clear();
+	return holds(d, 0, 3000) && holds(a, 5000, 10) && holds(b, 0, 0);
+}
+
+bool check1() {
+	return moves<sjtu::map<int, std::string> >() && moves<sjtu::map<int, std::string, std::less<int>, false, true> >()
+		&& moves<sjtu::art_map<int, std::string> >() && moves<sjtu::bloom_map<int, std::string> >()
+		&& moves<sjtu::buffered_map<int, std::string, std::less<int>, 16> >();
+}
+
+bool check2() { //the cache keeps its recency order and counters through a move, the interval map its queries
+	sjtu::lru_cache<int, int> a(3);
+	for (int i = 0; i < 5; ++i) a.put(i, i);
+	a.get(2);
+	sjtu::lru_cache<int, int> b(std::move(a));
+	b.put(9, 9);
+	if (b.contains(3) || !b.contains(2) || !b.contains(4) || a.size() != 0 || b.hits() != 1) return false;
+	a.put(1, 1);
+	swap(a, b);
+	if (a.size() != 3 || b.size() != 1) return false;
+
+	sjtu::interval_map<int, int> m, n;
+	for (int i = 0; i < 100; ++i) m.insert(sjtu::interval_map<int, int>::value_type(sjtu::pair<int, int>(i, i + 10), i));
+	n = std::move(m);
+	int hit = 0;
+	n.stab(50, [&](const sjtu::interval_map<int, int>::value_type &) { ++hit; });
+	return hit == 11 && n.size() == 100 && m.size() == 0;
+}
+
+bool check3() { //snapshots of a versioned map outlive moves of the map
+	sjtu::versioned_map<int, int> a;
+	for (int i = 0; i < 1000; ++i) a.insert(sjtu::versioned_map<int, int>::value_type(i, i));
+	sjtu::versioned_map<int, int>::snapshot s = a.snap();
+	sjtu::versioned_map<int, int> b(std::move(a)), c;
+	c.insert(sjtu::versioned_map<int, int>::value_type(-1, -1));
+	swap(b, c);
+	a = std::move(b);
+	return s.size() == 1000 && a.count(-1) == 1 && b.size() == 0 && c.size() == 1000 && c.snap().count(999) == 1;
+}
+
+int main() {
+	if (!check1()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check3()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	return 0;
+}
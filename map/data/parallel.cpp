@@ -0,0 +1,108 @@
+#include<iostream>
+#include<map>
+#include<atomic>
+#include<chrono>
+#include<cstdio>
+#include<cstdlib>
+#include "map_parallel.hpp"
+
+using namespace std;
+
+template<class Map>
+int counted(typename Map::node *t, bool &ok){ //recount every subtree and compare with the stored sizes
+	if(t == nullptr) return 0;
+	int n = counted<Map>(t -> left, ok) + counted<Map>(t -> right, ok) + 1;
+	if(n != t -> cnt) ok = false;
+	return n;
+}
+
+template<class Map>
+bool check_sizes(){ //subtree sizes survive every kind of update
+	Map Q;
+	std::map<int, int> stdQ;
+	for(int i = 1; i <= 100000; i++){
+		int op = rand() % 6, k = rand() % 20000;
+		if(op == 0) Q[k] = i, stdQ[k] = i;
+		else if(op == 1) Q.insert(typename Map::value_type(k, i)), stdQ.insert(std::map<int, int>::value_type(k, i));
+		else if(op == 2) Q.erase(k), stdQ.erase(k);
+		else if(op == 3) Q.find(k);
+		else if(op == 4 && i % 100 == 0){
+			typename Map::iterator first = Q.find(k), last = Q.find(k + 50);
+			if(first != Q.end() && last != Q.end()){
+				Q.erase(first, last);
+				stdQ.erase(stdQ.find(k), stdQ.find(k + 50));
+			}
+		}
+		else if(op == 5 && i % 5000 == 0){
+			Q.erase_if([&](const typename Map::value_type &v){ return v.second % 3 == 0; });
+			for(std::map<int, int>::iterator it = stdQ.begin(); it != stdQ.end(); )
+				if(it -> second % 3 == 0) stdQ.erase(it++); else ++it;
+		}
+		if(i % 10000 == 0){
+			bool ok = true;
+			if(counted<Map>(Q.root, ok) != (int) stdQ.size() || !ok) return 0;
+		}
+	}
+	Map P(Q);
+	bool ok = true;
+	return counted<Map>(P.root, ok) == (int) stdQ.size() && ok;
+}
+
+bool check1(){
+	return check_sizes<sjtu::map<int, int> >() && check_sizes<sjtu::map<int, int, std::less<int>, true> >();
+}
+
+bool check2(){ //split gives pieces within one of each other, for whole maps and subranges
+	sjtu::map<int, int> Q;
+	for(int i = 0; i < 10000; i++) Q[rand() % 100000] = i;
+	sjtu::map<int, int>::const_iterator b[33];
+	for(int t = 0; t < 100; t++){
+		int k = rand() % 32 + 1;
+		sjtu::map<int, int>::const_iterator first = Q.cbegin(), last = Q.cend();
+		if(t % 2){
+			for(int s = rand() % 1000; s > 0; s--) ++first;
+			for(int s = rand() % 1000; s > 0; s--) --last;
+		}
+		Q.split(first, last, k, b);
+		if(b[0] != first || b[k] != last) return 0;
+		int lo = 1 << 30, hi = 0, total = 0;
+		for(int i = 0; i < k; i++){
+			int n = 0;
+			for(sjtu::map<int, int>::const_iterator it = b[i]; it != b[i + 1]; ++it) ++n;
+			lo = min(lo, n), hi = max(hi, n), total += n;
+		}
+		int expect = 0;
+		for(sjtu::map<int, int>::const_iterator it = first; it != last; ++it) ++expect;
+		if(hi - lo > 1 || total != expect) return 0;
+	}
+	return 1;
+}
+
+bool check3(){ //parallel aggregation matches the sequential one and exceptions come back
+	sjtu::map<int, long long> Q;
+	for(int i = 0; i < 2000000; i++) Q[(int) ((long long) rand() * rand() % 1000000007)] = i;
+	long long expect = 0;
+	auto t0 = chrono::steady_clock::now();
+	for(sjtu::map<int, long long>::iterator it = Q.begin(); it != Q.end(); ++it) expect += it -> second * (it -> first % 7);
+	auto t1 = chrono::steady_clock::now();
+	std::atomic<long long> sum(0);
+	sjtu::parallel_for_each(Q, [&](sjtu::pair<const int, long long> &v){ sum += v.second * (v.first % 7); });
+	auto t2 = chrono::steady_clock::now();
+	printf("sequential %.3fs, parallel %.3fs ", chrono::duration<double>(t1 - t0).count(), chrono::duration<double>(t2 - t1).count());
+	if(sum != expect) return 0;
+	sjtu::parallel_for_each(Q, [](sjtu::pair<const int, long long> &v){ v.second = -v.second; }, 3);
+	for(sjtu::map<int, long long>::iterator it = Q.begin(); it != Q.end(); ++it) expect += it -> second * (it -> first % 7);
+	if(expect != 0) return 0;
+	try{
+		sjtu::parallel_for_each(Q, [](sjtu::pair<const int, long long> &v){ if(v.second == -1234) throw sjtu::runtime_error(); }, 4);
+	}
+	catch(sjtu::runtime_error &){ return 1; }
+	return 0;
+}
+
+int main(){
+	if(!check1()) cout << "Test 1 Failed......" << endl; else cout << "Test 1 Passed!" << endl;
+	if(!check2()) cout << "Test 2 Failed......" << endl; else cout << "Test 2 Passed!" << endl;
+	if(!check3()) cout << "Test 3 Failed......" << endl; else cout << "Test 3 Passed!" << endl;
+	return 0;
+}
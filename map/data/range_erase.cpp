@@ -0,0 +1,72 @@
+#include<iostream>
+#include<map>
+#include<cstdio>
+#include<cstdlib>
+#include "map1.hpp"
+
+using namespace std;
+
+typedef sjtu::map<int, int> Map;
+
+int subtree(Map::node *t, Map::node *f){
+	if(t == nullptr) return 0;
+	if(t -> father != f) return -1000000;
+	return 1 + subtree(t -> left, t) + subtree(t -> right, t);
+}
+
+bool same(Map &Q, std::map<int, int> &stdQ){
+	if(Q.size() != stdQ.size()) return 0;
+	std::map<int, int>::iterator stdit = stdQ.begin();
+	for(Map::iterator it = Q.begin(); it != Q.end(); it++, stdit++)
+		if(it -> first != stdit -> first || it -> second != stdit -> second) return 0;
+	return subtree(Q.root, nullptr) == (int)stdQ.size();
+}
+
+int mod;
+bool divisible(const Map::value_type &p){
+	return p.first % mod == 0;
+}
+
+bool check1(){ //erase by key, by range & erase_if
+	Map Q;
+	std::map<int, int> stdQ;
+	for(int round = 1; round <= 3000; round++){
+		for(int i = 1; i <= 40; i++){
+			int k = rand() % 2000;
+			Q[k] = i; stdQ[k] = i;
+		}
+		int op = rand() % 4;
+		if(op == 0){
+			int k = rand() % 2000;
+			if(Q.erase(k) != stdQ.erase(k)) return 0;
+		}
+		else if(op == 1){
+			std::map<int, int>::iterator a = stdQ.begin(), b;
+			for(int d = rand() % stdQ.size(); d > 0; d--) a++;
+			b = a;
+			for(int d = rand() % 100; d > 0 && b != stdQ.end(); d--) b++;
+			Map::iterator last = b == stdQ.end() ? Q.end() : Q.find(b -> first);
+			if(Q.erase(Q.find(a -> first), last) != last) return 0;
+			stdQ.erase(a, b);
+		}
+		else if(op == 2){
+			mod = rand() % 7 + 2;
+			size_t cnt = 0;
+			for(std::map<int, int>::iterator it = stdQ.begin(); it != stdQ.end(); )
+				if(divisible(Map::value_type(it -> first, it -> second))){
+					stdQ.erase(it++);
+					cnt++;
+				}
+				else it++;
+			if(Q.erase_if(divisible) != cnt) return 0;
+		}
+		if(!same(Q, stdQ)) return 0;
+	}
+	Q.erase(Q.begin(), Q.end());
+	return Q.empty() && Q.root == nullptr;
+}
+
+int main(){
+	if(!check1()) cout << "Test 1 Failed......" << endl; else cout << "Test 1 Passed!" << endl;
+	return 0;
+}
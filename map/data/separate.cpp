@@ -0,0 +1,92 @@
+#include<iostream>
+#include<map>
+#include<string>
+#include<ctime>
+#include<cstdio>
+#include<cstdlib>
+#include "map1.hpp"
+
+using namespace std;
+
+struct Big{ //a large value, like a small matrix
+	double a[64];
+	int id;
+	Big(int x = 0): id(x){ for(int i = 0; i < 64; i++) a[i] = x + i; }
+};
+
+template<class Map>
+bool check_same(){ //behaves like std::map in both storage modes
+	Map Q;
+	std::map<int, int> stdQ;
+	for(int i = 1; i <= 100000; i++){
+		int op = rand() % 5, k = rand() % 10000;
+		if(op == 0) Q[k] = Big(i), stdQ[k] = i;
+		else if(op == 1) Q.insert(typename Map::value_type(k, Big(i))), stdQ.insert(std::map<int, int>::value_type(k, i));
+		else if(op == 2) Q.erase(k), stdQ.erase(k);
+		else if(op == 3 && i % 1000 == 0){
+			Q.erase_if([](const typename Map::value_type &v){ return v.second.id % 5 == 0; });
+			for(std::map<int, int>::iterator it = stdQ.begin(); it != stdQ.end(); )
+				if(it -> second % 5 == 0) stdQ.erase(it++); else ++it;
+		}
+		else if(Q.count(k) != stdQ.count(k)) return 0;
+	}
+	Map P;
+	P = Q;
+	Q.clear();
+	if(P.size() != stdQ.size()) return 0;
+	typename Map::iterator it = P.begin();
+	for(std::map<int, int>::iterator jt = stdQ.begin(); jt != stdQ.end(); ++jt, ++it)
+		if(it -> first != jt -> first || it -> second.id != jt -> second || it -> second.a[63] != jt -> second + 63) return 0;
+	return it == P.end();
+}
+
+bool check1(){
+	return check_same<sjtu::map<int, Big> >() && check_same<sjtu::map<int, Big, std::less<int>, false, true> >()
+		&& check_same<sjtu::map<int, Big, std::less<int>, true, true> >();
+}
+
+bool check2(){ //values stay at one address while the tree is splayed and reshaped around them
+	sjtu::map<string, Big, std::less<string>, true, true> Q;
+	for(int i = 0; i < 1000; i++) Q[to_string(i)] = Big(i);
+	Big *p[1000];
+	for(int i = 0; i < 1000; i++) p[i] = &Q.at(to_string(i));
+	for(int i = 0; i < 100000; i++){
+		int k = rand() % 3000;
+		if(k < 1000) Q.find(to_string(k));
+		else if(rand() % 2) Q[to_string(k)] = Big(k);
+		else Q.erase(to_string(k));
+	}
+	for(int i = 0; i < 1000; i++) if(&Q.at(to_string(i)) != p[i] || p[i] -> id != i) return 0;
+	return 1;
+}
+
+template<class Map>
+double lookups(Map &Q, long long &sum){
+	for(int i = 0; i < 200000; i++) Q[rand()] = Big(i);
+	clock_t t0 = clock();
+	for(int i = 0; i < 2000000; i++){
+		typename Map::iterator it = Q.find(rand());
+		if(it != Q.end()) sum += it -> second.id;
+	}
+	return (double) (clock() - t0) / CLOCKS_PER_SEC;
+}
+
+bool check3(){ //lookups that miss touch only the small nodes
+	sjtu::map<int, Big> A;
+	sjtu::map<int, Big, std::less<int>, false, true> B;
+	long long s1 = 0, s2 = 0;
+	srand(7);
+	double t1 = lookups(A, s1);
+	srand(7);
+	double t2 = lookups(B, s2);
+	printf("node size %d vs %d bytes, lookups %.3fs vs %.3fs ", (int) sizeof(sjtu::map<int, Big>::node),
+		(int) sizeof(sjtu::map<int, Big, std::less<int>, false, true>::node), t1, t2);
+	return s1 == s2;
+}
+
+int main(){
+	if(!check1()) cout << "Test 1 Failed......" << endl; else cout << "Test 1 Passed!" << endl;
+	if(!check2()) cout << "Test 2 Failed......" << endl; else cout << "Test 2 Passed!" << endl;
+	if(!check3()) cout << "Test 3 Failed......" << endl; else cout << "Test 3 Passed!" << endl;
+	return 0;
+}
@@ -0,0 +1,145 @@
+#include<iostream>
+#include<string>
+#include<ctime>
+#include<cstdio>
+#include<cstdlib>
+#include<fcntl.h>
+#include<unistd.h>
+#include "map_io.hpp"
+
+using namespace std;
+
+struct Name{ //not trivially copyable, so it needs its own serializer
+	string first, last;
+};
+
+namespace sjtu{
+	template<>
+	struct serializer<Name>{
+		static const size_t fixed = 0;
+		static void save(fd_writer &out, const Name &x){
+			serializer<string>::save(out, x.first);
+			serializer<string>::save(out, x.last);
+		}
+		static void load(fd_reader &in, Name &x){
+			serializer<string>::load(in, x.first);
+			serializer<string>::load(in, x.last);
+		}
+	};
+}
+
+int scratch(){
+	char path[] = "/tmp/sjtu_map_XXXXXX";
+	int fd = mkstemp(path);
+	unlink(path);
+	return fd;
+}
+
+bool check1(){ //a large map of plain values round trips
+	sjtu::map<long long, double> Q, P;
+	for(int i = 0; i < 1000000; i++) Q[(long long) rand() * rand()] = i * 0.5;
+	int fd = scratch();
+	clock_t t0 = clock();
+	sjtu::save(Q, fd);
+	lseek(fd, 0, SEEK_SET);
+	P[1] = 1;
+	sjtu::load(P, fd);
+	printf("saved and loaded %d entries in %.2fs ", (int) Q.size(), (double) (clock() - t0) / CLOCKS_PER_SEC);
+	close(fd);
+	if(P.size() != Q.size()) return 0;
+	sjtu::map<long long, double>::const_iterator i = Q.cbegin(), j = P.cbegin();
+	for(; i != Q.cend(); ++i, ++j)
+		if(i -> first != j -> first || i -> second != j -> second) return 0;
+	return j == P.cend() && P.count(Q.cbegin() -> first);
+}
+
+bool check2(){ //custom types go through their serializers
+	sjtu::map<string, Name> Q, P;
+	for(int i = 0; i < 1000; i++) Q[to_string(i)] = Name{string(i % 7, 'a'), to_string(i * i)};
+	int fd = scratch();
+	sjtu::save(Q, fd);
+	lseek(fd, 0, SEEK_SET);
+	sjtu::load(P, fd);
+	close(fd);
+	if(P.size() != 1000) return 0;
+	for(int i = 0; i < 1000; i++){
+		Name &n = P.at(to_string(i));
+		if(n.first != string(i % 7, 'a') || n.last != to_string(i * i)) return 0;
+	}
+	return 1;
+}
+
+bool check3(){ //a truncated or mismatched file is rejected and leaves the map empty
+	sjtu::map<int, int> Q, P;
+	for(int i = 0; i < 100; i++) Q[i] = i;
+	int fd = scratch();
+	sjtu::save(Q, fd);
+	if(ftruncate(fd, lseek(fd, 0, SEEK_CUR) - 4) != 0) return 0;
+	lseek(fd, 0, SEEK_SET);
+	bool thrown = false;
+	try{ sjtu::load(P, fd); }
+	catch(sjtu::runtime_error &){ thrown = true; }
+	if(!thrown || !P.empty()) return 0;
+	sjtu::map<int, long long> R;
+	lseek(fd, 0, SEEK_SET);
+	thrown = false;
+	try{ sjtu::load(R, fd); }
+	catch(sjtu::runtime_error &){ thrown = true; }
+	close(fd);
+	return thrown && R.empty();
+}
+
+bool check4(){ //a string length past the end of the file is rejected without allocating it
+	sjtu::map<int, string> Q, P;
+	Q[1] = "one";
+	int fd = scratch();
+	sjtu::save(Q, fd);
+	uint64_t huge = 1ULL << 50;
+	if(pwrite(fd, &huge, sizeof(huge), 4 * sizeof(uint64_t) + sizeof(int)) != sizeof(huge)) return 0;
+	lseek(fd, 0, SEEK_SET);
+	bool thrown = false;
+	try{ sjtu::load(P, fd); }
+	catch(sjtu::runtime_error &){ thrown = true; }
+	close(fd);
+	return thrown && P.empty();
+}
+
+bool check5(){ //two maps and a trailer back to back on one fd, seekable or not
+	sjtu::map<int, string> Q, R, P;
+	for(int i = 0; i < 1000; i++) Q[i] = to_string(i), R[-i] = string(i % 5, 'r');
+	int trailer = 12345, got = 0;
+	int fd = scratch();
+	sjtu::save(Q, fd);
+	sjtu::save(R, fd);
+	if(write(fd, &trailer, sizeof(trailer)) != sizeof(trailer)) return 0;
+	lseek(fd, 0, SEEK_SET);
+	sjtu::load(P, fd);
+	if(P.size() != Q.size() || P.at(999) != "999") return 0;
+	sjtu::load(P, fd);
+	if(P.size() != R.size() || P.at(-999) != "rrrr") return 0;
+	if(read(fd, &got, sizeof(got)) != sizeof(got) || got != trailer) return 0;
+	close(fd);
+	int pipefd[2];
+	if(pipe(pipefd) != 0) return 0;
+	sjtu::map<int, int> S, T;
+	S[1] = 2;
+	sjtu::save(S, pipefd[1]);
+	sjtu::save(S, pipefd[1]);
+	if(write(pipefd[1], &trailer, sizeof(trailer)) != sizeof(trailer)) return 0;
+	close(pipefd[1]);
+	sjtu::load(T, pipefd[0]);
+	sjtu::load(T, pipefd[0]);
+	got = 0;
+	bool ok = T.size() == 1 && T.at(1) == 2 && read(pipefd[0], &got, sizeof(got)) == sizeof(got) && got == trailer;
+	close(pipefd[0]);
+	return ok;
+}
+
+int main(){
+	if(!check1()) cout << "Test 1 Failed......" << endl; else cout << "Test 1 Passed!" << endl;
+	if(!check2()) cout << "Test 2 Failed......" << endl; else cout << "Test 2 Passed!" << endl;
+	if(!check3()) cout << "Test 3 Failed......" << endl; else cout << "Test 3 Passed!" << endl;
+	if(!check4()) cout << "Test 4 Failed......" << endl; else cout << "Test 4 Passed!" << endl;
+	if(!check5()) cout << "Test 5 Failed......" << endl; else cout << "Test 5 Passed!" << endl;
+	return 0;
+}
@@ -0,0 +1,61 @@
+#include<iostream>
+#include<map>
+#include<cmath>
+#include<ctime>
+#include<cstdio>
+#include<cstdlib>
+#include<algorithm>
+#include "map1.hpp"
+
+using namespace std;
+
+const int N = 100000;
+const int M = 2000000;
+const double S = 1.2;
+
+int keys[N], queries[M];
+double cdf[N];
+
+template<class Map>
+int depth(const Map &Q, int key){
+	int ret = 0;
+	for(typename Map::node *p = Q.search(key); p != nullptr; p = p -> father) ret++;
+	return ret;
+}
+
+template<class Map>
+void run(const char *name){
+	Map Q;
+	for(int i = 0; i < N; i++) Q[keys[i]] = i;
+	long long visits = 0, sum = 0;
+	for(int i = 0; i < M; i++){
+		visits += depth(Q, queries[i]);
+		Q.find(queries[i]);
+	}
+	clock_t start = clock();
+	for(int i = 0; i < M; i++) sum += Q.find(queries[i]) -> second;
+	double t = 1.0 * (clock() - start) / CLOCKS_PER_SEC;
+	printf("%-6s  visits per lookup: %8.3f  time: %.3fs  (%lld)\n", name, 1.0 * visits / M, t, sum);
+}
+
+int main(){
+	srand(19260817);
+	for(int i = 0; i < N; i++) keys[i] = rand();
+	sort(keys, keys + N);
+	int n = unique(keys, keys + N) - keys;
+	for(int i = n; i < N; i++) keys[i] = keys[i - n] + 1;
+	random_shuffle(keys, keys + N);
+	double total = 0;
+	for(int i = 0; i < N; i++) total += 1.0 / pow(i + 1, S);
+	for(int i = 0; i < N; i++) cdf[i] = (i ? cdf[i - 1] : 0) + 1.0 / pow(i + 1, S) / total;
+	for(int i = 0; i < M; i++){
+		double u = 1.0 * rand() / RAND_MAX;
+		int rank = lower_bound(cdf, cdf + N, u) - cdf;
+		queries[i] = keys[min(rank, N - 1)];
+	}
+	random_shuffle(keys, keys + N);
+	printf("Zipf(s = %.1f) lookups over %d keys\n", S, N);
+	run<sjtu::map<int, int> >("plain");
+	run<sjtu::map<int, int, std::less<int>, true> >("splay");
+	return 0;
+}
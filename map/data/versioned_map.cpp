@@ -0,0 +1,90 @@
+#include<iostream>
+#include<map>
+#include<thread>
+#include<atomic>
+#include<cstdio>
+#include<cstdlib>
+#include "versioned_map.hpp"
+
+using namespace std;
+
+typedef sjtu::versioned_map<int, int> VMap;
+
+bool same(const VMap::snapshot &s, const std::map<int, int> &m){
+	if(s.size() != m.size()) return 0;
+	VMap::const_iterator it = s.begin();
+	for(std::map<int, int>::const_iterator jt = m.begin(); jt != m.end(); ++jt, ++it)
+		if(it == s.end() || it -> first != jt -> first || it -> second != jt -> second) return 0;
+	return it == s.end();
+}
+
+bool check1(){ //every snapshot keeps showing the version it was taken at
+	VMap Q;
+	std::map<int, int> stdQ;
+	VMap::snapshot olds[20];
+	std::map<int, int> oldm[20];
+	for(int i = 1; i <= 100000; i++){
+		int op = rand() % 4, k = rand() % 5000;
+		if(op == 0) Q.assign(k, i), stdQ[k] = i;
+		else if(op == 1){
+			if(Q.insert(VMap::value_type(k, i)) != stdQ.insert(std::map<int, int>::value_type(k, i)).second) return 0;
+		}
+		else if(op == 2){
+			if(Q.erase(k) != stdQ.erase(k)) return 0;
+		}
+		else if(Q.count(k) != stdQ.count(k)) return 0;
+		if(i % 5000 == 0){
+			olds[i / 5000 - 1] = Q.snap();
+			oldm[i / 5000 - 1] = stdQ;
+		}
+	}
+	for(int i = 0; i < 20; i++) if(!same(olds[i], oldm[i])) return 0;
+	VMap P(Q);
+	Q.clear();
+	VMap::snapshot s = P.snap();
+	VMap::const_iterator it = s.end();
+	for(std::map<int, int>::reverse_iterator jt = stdQ.rbegin(); jt != stdQ.rend(); ++jt)
+		if((--it) -> first != jt -> first) return 0;
+	return it == s.begin() && Q.empty() && same(s, stdQ);
+}
+
+bool check2(){ //a reader iterates snapshots while a writer keeps going
+	VMap Q;
+	for(int i = 0; i < 20000; i++) Q.assign(i, 0);
+	std::atomic<bool> done(false);
+	std::thread writer([&](){
+		//every version holds keys 0..19999, each with the same value except for the one being changed
+		for(int round = 1; round <= 20; round++)
+			for(int i = 0; i < 20000; i++){
+				Q.erase(i);
+				Q.insert(VMap::value_type(i, round));
+			}
+		done = true;
+	});
+	bool ok = true;
+	int views = 0;
+	while(!done || views == 0){
+		VMap::snapshot s = Q.snap();
+		long long sum = 0, n = 0, lo = 1 << 30, hi = -1;
+		int last = -1;
+		for(VMap::const_iterator it = s.begin(); it != s.end(); ++it){
+			if(it -> first <= last) ok = false;
+			last = it -> first;
+			sum += it -> second;
+			++n;
+			if(it -> second < lo) lo = it -> second;
+			if(it -> second > hi) hi = it -> second;
+		}
+		if((size_t) n != s.size() || n < 19999 || hi - lo > 1) ok = false;
+		++views;
+	}
+	writer.join();
+	VMap::snapshot s = Q.snap();
+	return ok && s.size() == 20000 && s.at(12345) == 20 && s.version() == 20000 + 20 * 40000;
+}
+
+int main(){
+	if(!check1()) cout << "Test 1 Failed......" << endl; else cout << "Test 1 Passed!" << endl;
+	if(!check2()) cout << "Test 2 Failed......" << endl; else cout << "Test 2 Passed!" << endl;
+	return 0;
+}
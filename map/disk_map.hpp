@@ -0,0 +1,614 @@
+/**
+ * implement a container like std::map, persisted as a B+tree in a memory-mapped file
+ */
+#ifndef SJTU_DISK_MAP_HPP
+#define SJTU_DISK_MAP_HPP
+
+#include <functional>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+    /**
+     * Key and T must be trivially copyable: entries are stored as raw bytes in
+     * PageSize-sized pages, so reopening a file needs no rebuilding at all.
+     * References returned by the iterators point into the mapping and are
+     * invalidated by the next insertion, since the file may be remapped to grow.
+     * Leaves are only released once they become empty, underfull pages are never merged.
+     */
+    template<
+            class Key,
+            class T,
+            class Compare = std::less<Key>,
+            size_t PageSize = 4096,
+            int DirtyPages = 64
+    > class disk_map {
+    public:
+        typedef pair<const Key, T> value_type;
+        typedef unsigned int page_id;
+        static_assert(std::is_trivially_copyable<Key>::value, "disk_map needs a trivially copyable Key");
+        static_assert(std::is_trivially_copyable<T>::value, "disk_map needs a trivially copyable T");
+
+        struct page_header {
+            int leaf;
+            int cnt;
+            page_id next, prev;
+        };
+        static const int LEAF_CAP = (PageSize - sizeof(page_header)) / sizeof(value_type);
+        static const int INNER_CAP = (PageSize - sizeof(page_header) - 2 * sizeof(page_id) - alignof(Key))
+                                     / (sizeof(Key) + sizeof(page_id));
+        struct leaf_node {
+            page_header h;
+            value_type data[LEAF_CAP];
+        };
+        struct inner_node {
+            page_header h;
+            Key key[INNER_CAP];
+            page_id child[INNER_CAP + 1];
+        };
+        struct meta_page {
+            char magic[8];
+            unsigned int page_size, key_size, value_size;
+            page_id root, first, last, count, free;
+            unsigned long long len;
+        };
+        static_assert(LEAF_CAP >= 3 && INNER_CAP >= 3, "PageSize is too small for this Key and T");
+        static_assert(sizeof(leaf_node) <= PageSize && sizeof(inner_node) <= PageSize, "page overflow");
+        static const page_id INIT_PAGES = 16;
+        static const int MAX_HEIGHT = 64;
+
+        int fd;
+        char *base;
+        page_id capacity;
+        page_id dirty[DirtyPages];
+        int ndirty;
+        bool lost;
+        Compare com;
+
+        meta_page *meta() const {
+            return reinterpret_cast<meta_page*>(base);
+        }
+        leaf_node *leaf(page_id p) const {
+            return reinterpret_cast<leaf_node*>(base + (size_t) p * PageSize);
+        }
+        inner_node *inner(page_id p) const {
+            return reinterpret_cast<inner_node*>(base + (size_t) p * PageSize);
+        }
+        /**
+         * map the file at its new size before resizing it and dropping the old mapping, so a failure
+         * at either step throws with the old mapping and capacity still in place
+         */
+        void remap(page_id pages) {
+            void *addr = mmap(nullptr, (size_t) pages * PageSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (addr == MAP_FAILED) throw runtime_error();
+            if (ftruncate(fd, (off_t) pages * PageSize) != 0) {
+                munmap(addr, (size_t) pages * PageSize);
+                throw runtime_error();
+            }
+            if (base != nullptr) munmap(base, (size_t) capacity * PageSize);
+            base = (char*) addr;
+            capacity = pages;
+        }
+        void sync(page_id p, int flag) {
+            msync(base + (size_t) p * PageSize, PageSize, flag);
+        }
+        /**
+         * sync the pages in the dirty list, or the whole mapping once the list has lost track of some
+         */
+        void writeback(int flag) {
+            if (lost) msync(base, (size_t) capacity * PageSize, flag);
+            else {
+                for (int i = 0; i < ndirty; ++i) sync(dirty[i], flag);
+                sync(0, flag);
+            }
+            ndirty = 0;
+            lost = false;
+        }
+        /**
+         * when the list is full its pages are only started on their way with MS_ASYNC, which promises
+         * nothing, so the next MS_SYNC covers the whole mapping
+         */
+        void touch(page_id p) {
+            for (int i = 0; i < ndirty; ++i)
+                if (dirty[i] == p) return;
+            if (ndirty == DirtyPages) {
+                writeback(MS_ASYNC);
+                lost = true;
+            }
+            dirty[ndirty++] = p;
+        }
+        /**
+         * grow the file now if fewer than n pages could be allocated without growing it,
+         * so that a split, which takes up to one page per level, never fails halfway
+         */
+        void reserve(page_id n) {
+            page_id c = capacity;
+            while (c - meta()->count < n) c *= 2;
+            if (c != capacity) remap(c);
+        }
+        page_id allocate(int is_leaf) {
+            page_id p = meta()->free;
+            if (p != 0) meta()->free = leaf(p)->h.next;
+            else {
+                if (meta()->count == capacity) remap(capacity * 2);
+                p = meta()->count++;
+            }
+            page_header &h = leaf(p)->h;
+            h.leaf = is_leaf;
+            h.cnt = 0;
+            h.next = h.prev = 0;
+            touch(p);
+            return p;
+        }
+        void release(page_id p) {
+            leaf(p)->h.next = meta()->free;
+            meta()->free = p;
+            touch(p);
+        }
+        void format() {
+            remap(INIT_PAGES);
+            meta_page *m = meta();
+            memset(m, 0, sizeof(meta_page));
+            memcpy(m->magic, "SJTUBPT", 8);
+            m->page_size = PageSize;
+            m->key_size = sizeof(Key);
+            m->value_size = sizeof(T);
+            m->count = 1;
+            m->root = m->first = m->last = allocate(1);
+        }
+        int leaf_lower(const leaf_node *p, const Key &k) const {
+            int l = 0, r = p->h.cnt;
+            while (l < r) {
+                int mid = (l + r) >> 1;
+                if (com(p->data[mid].first, k)) l = mid + 1;
+                else r = mid;
+            }
+            return l;
+        }
+        int inner_upper(const inner_node *p, const Key &k) const {
+            int l = 0, r = p->h.cnt;
+            while (l < r) {
+                int mid = (l + r) >> 1;
+                if (com(k, p->key[mid])) r = mid;
+                else l = mid + 1;
+            }
+            return l;
+        }
+        /**
+         * descend to the leaf that may hold k, remembering the inner pages and child slots on the way
+         */
+        page_id descend(const Key &k, page_id *path, int *slot, int &height) const {
+            page_id p = meta()->root;
+            height = 0;
+            while (!leaf(p)->h.leaf) {
+                int i = inner_upper(inner(p), k);
+                if (path != nullptr) {
+                    path[height] = p;
+                    slot[height] = i;
+                }
+                ++height;
+                p = inner(p)->child[i];
+            }
+            return p;
+        }
+        bool locate(const Key &k, page_id &p, int &i) const {
+            int height;
+            p = descend(k, nullptr, nullptr, height);
+            i = leaf_lower(leaf(p), k);
+            return i < leaf(p)->h.cnt && !com(k, leaf(p)->data[i].first);
+        }
+        void insert_inner(page_id *path, int *slot, int height, Key sep, page_id right) {
+            while (height > 0) {
+                --height;
+                page_id p = path[height];
+                int s = slot[height];
+                inner_node *q = inner(p);
+                touch(p);
+                if (q->h.cnt < INNER_CAP) {
+                    memmove(q->key + s + 1, q->key + s, (q->h.cnt - s) * sizeof(Key));
+                    memmove(q->child + s + 2, q->child + s + 1, (q->h.cnt - s) * sizeof(page_id));
+                    q->key[s] = sep;
+                    q->child[s + 1] = right;
+                    ++q->h.cnt;
+                    return;
+                }
+                Key keys[INNER_CAP + 1];
+                page_id kids[INNER_CAP + 2];
+                memcpy(keys, q->key, s * sizeof(Key));
+                keys[s] = sep;
+                memcpy(keys + s + 1, q->key + s, (INNER_CAP - s) * sizeof(Key));
+                memcpy(kids, q->child, (s + 1) * sizeof(page_id));
+                kids[s + 1] = right;
+                memcpy(kids + s + 2, q->child + s + 1, (INNER_CAP - s) * sizeof(page_id));
+                page_id np = allocate(0);
+                q = inner(p);
+                inner_node *nq = inner(np);
+                int half = (INNER_CAP + 1) / 2;
+                q->h.cnt = half;
+                memcpy(q->key, keys, half * sizeof(Key));
+                memcpy(q->child, kids, (half + 1) * sizeof(page_id));
+                nq->h.cnt = INNER_CAP - half;
+                memcpy(nq->key, keys + half + 1, nq->h.cnt * sizeof(Key));
+                memcpy(nq->child, kids + half + 1, (nq->h.cnt + 1) * sizeof(page_id));
+                sep = keys[half];
+                right = np;
+            }
+            page_id nr = allocate(0);
+            inner_node *r = inner(nr);
+            r->h.cnt = 1;
+            r->key[0] = sep;
+            r->child[0] = meta()->root;
+            r->child[1] = right;
+            meta()->root = nr;
+        }
+        page_id insert_at(page_id *path, int *slot, int height, page_id p, int i, const value_type &value, int &at) {
+            if (leaf(p)->h.cnt == LEAF_CAP) reserve(height + 2);
+            leaf_node *q = leaf(p);
+            touch(p);
+            if (q->h.cnt < LEAF_CAP) {
+                memmove((void*) (q->data + i + 1), q->data + i, (q->h.cnt - i) * sizeof(value_type));
+                memcpy((void*) (q->data + i), &value, sizeof(value_type));
+                ++q->h.cnt;
+                ++meta()->len;
+                at = i;
+                return p;
+            }
+            page_id np = allocate(1);
+            q = leaf(p);
+            leaf_node *nq = leaf(np);
+            int half = (LEAF_CAP + 1) / 2;
+            nq->h.cnt = LEAF_CAP - half;
+            memcpy((void*) nq->data, q->data + half, nq->h.cnt * sizeof(value_type));
+            q->h.cnt = half;
+            nq->h.next = q->h.next;
+            nq->h.prev = p;
+            if (q->h.next != 0) {
+                leaf(q->h.next)->h.prev = np;
+                touch(q->h.next);
+            }
+            else meta()->last = np;
+            q->h.next = np;
+            page_id ret = p;
+            if (i >= half) {
+                ret = np;
+                i -= half;
+            }
+            leaf_node *t = leaf(ret);
+            memmove((void*) (t->data + i + 1), t->data + i, (t->h.cnt - i) * sizeof(value_type));
+            memcpy((void*) (t->data + i), &value, sizeof(value_type));
+            ++t->h.cnt;
+            ++meta()->len;
+            at = i;
+            insert_inner(path, slot, height, nq->data[0].first, np);
+            return ret;
+        }
+        /**
+         * unlink the page at path[height] level from its parents, dropping inner pages that become childless
+         */
+        void remove_child(page_id *path, int *slot, int height) {
+            while (height > 0) {
+                --height;
+                page_id p = path[height];
+                int s = slot[height];
+                inner_node *q = inner(p);
+                touch(p);
+                if (q->h.cnt > 0) {
+                    int k = s > 0 ? s - 1 : 0;
+                    memmove(q->key + k, q->key + k + 1, (q->h.cnt - k - 1) * sizeof(Key));
+                    memmove(q->child + s, q->child + s + 1, (q->h.cnt - s) * sizeof(page_id));
+                    --q->h.cnt;
+                    break;
+                }
+                release(p);
+            }
+            page_id r = meta()->root;
+            while (!leaf(r)->h.leaf && inner(r)->h.cnt == 0) {
+                meta()->root = inner(r)->child[0];
+                release(r);
+                r = meta()->root;
+            }
+        }
+        class const_iterator;
+        class iterator {
+        private:
+            friend const_iterator;
+        public:
+            page_id page;
+            int index;
+            disk_map *it;
+            iterator(page_id p = 0, int i = 0, disk_map *obj = nullptr) {
+                page = p;
+                index = i;
+                it = obj;
+            }
+            iterator operator++(int) {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+            iterator & operator++() {
+                it->forward(page, index);
+                return *this;
+            }
+            iterator operator--(int) {
+                iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+            iterator & operator--() {
+                it->backward(page, index);
+                return *this;
+            }
+            value_type & operator*() const {
+                if (page == 0) throw invalid_iterator();
+                it->touch(page);
+                return it->leaf(page)->data[index];
+            }
+            value_type* operator->() const noexcept {
+                it->touch(page);
+                return &(it->leaf(page)->data[index]);
+            }
+            bool operator==(const iterator &rhs) const {
+                return page == rhs.page && index == rhs.index && it == rhs.it;
+            }
+            bool operator==(const const_iterator &rhs) const {
+                return page == rhs.page && index == rhs.index && it == rhs.it;
+            }
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+        class const_iterator {
+        private:
+            friend iterator;
+        public:
+            page_id page;
+            int index;
+            const disk_map *it;
+            const_iterator(page_id p = 0, int i = 0, const disk_map *obj = nullptr) {
+                page = p;
+                index = i;
+                it = obj;
+            }
+            const_iterator(const iterator &other) {
+                page = other.page;
+                index = other.index;
+                it = other.it;
+            }
+            const_iterator operator++(int) {
+                const_iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+            const_iterator & operator++() {
+                it->forward(page, index);
+                return *this;
+            }
+            const_iterator operator--(int) {
+                const_iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+            const_iterator & operator--() {
+                it->backward(page, index);
+                return *this;
+            }
+            const value_type & operator*() const {
+                if (page == 0) throw invalid_iterator();
+                return it->leaf(page)->data[index];
+            }
+            const value_type* operator->() const noexcept {
+                return &(it->leaf(page)->data[index]);
+            }
+            bool operator==(const iterator &rhs) const {
+                return page == rhs.page && index == rhs.index && it == rhs.it;
+            }
+            bool operator==(const const_iterator &rhs) const {
+                return page == rhs.page && index == rhs.index && it == rhs.it;
+            }
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+        void forward(page_id &p, int &i) const {
+            if (p == 0) throw invalid_iterator();
+            if (++i < leaf(p)->h.cnt) return;
+            p = leaf(p)->h.next;
+            i = 0;
+        }
+        void backward(page_id &p, int &i) const {
+            if (p == 0) {
+                p = meta()->last;
+                if (leaf(p)->h.cnt == 0) {
+                    p = 0;
+                    throw invalid_iterator();
+                }
+                i = leaf(p)->h.cnt - 1;
+                return;
+            }
+            if (i > 0) {
+                --i;
+                return;
+            }
+            if (leaf(p)->h.prev == 0) throw invalid_iterator();
+            p = leaf(p)->h.prev;
+            i = leaf(p)->h.cnt - 1;
+        }
+        /**
+         * open the tree stored in path, creating an empty one if the file is new
+         */
+        explicit disk_map(const char *path) {
+            base = nullptr;
+            capacity = 0;
+            ndirty = 0;
+            lost = false;
+            fd = open(path, O_RDWR | O_CREAT, 0644);
+            if (fd < 0) throw runtime_error();
+            try {
+                struct stat st;
+                if (fstat(fd, &st) != 0) throw runtime_error();
+                if (st.st_size == 0) {
+                    format();
+                    return;
+                }
+                if (st.st_size % PageSize != 0) throw runtime_error();
+                remap(st.st_size / PageSize);
+                meta_page *m = meta();
+                if (memcmp(m->magic, "SJTUBPT", 8) != 0 || m->page_size != PageSize
+                    || m->key_size != sizeof(Key) || m->value_size != sizeof(T)) throw runtime_error();
+            } catch (...) {
+                if (base != nullptr) munmap(base, (size_t) capacity * PageSize);
+                close(fd);
+                throw;
+            }
+        }
+        disk_map(const disk_map &other) = delete;
+        disk_map & operator=(const disk_map &other) = delete;
+        ~disk_map() {
+            writeback(MS_SYNC);
+            munmap(base, (size_t) capacity * PageSize);
+            close(fd);
+        }
+        /**
+         * write every page modified since the last flush back to the file, including those written
+         * through an iterator
+         */
+        void flush() {
+            writeback(MS_SYNC);
+        }
+        T & at(const Key &key) {
+            page_id p;
+            int i;
+            if (!locate(key, p, i)) throw index_out_of_bound();
+            touch(p);
+            return leaf(p)->data[i].second;
+        }
+        const T & at(const Key &key) const {
+            page_id p;
+            int i;
+            if (!locate(key, p, i)) throw index_out_of_bound();
+            return leaf(p)->data[i].second;
+        }
+        T & operator[](const Key &key) {
+            iterator ret = insert(value_type(key, T())).first;
+            touch(ret.page);
+            return ret->second;
+        }
+        const T & operator[](const Key &key) const {
+            return at(key);
+        }
+        iterator begin() {
+            if (meta()->len == 0) return end();
+            return iterator(meta()->first, 0, this);
+        }
+        const_iterator cbegin() const {
+            if (meta()->len == 0) return cend();
+            return const_iterator(meta()->first, 0, this);
+        }
+        iterator end() {
+            return iterator(0, 0, this);
+        }
+        const_iterator cend() const {
+            return const_iterator(0, 0, this);
+        }
+        bool empty() const {
+            return meta()->len == 0;
+        }
+        size_t size() const {
+            return meta()->len;
+        }
+        void clear() {
+            ndirty = 0;
+            format();
+        }
+        pair<iterator, bool> insert(const value_type &value) {
+            page_id path[MAX_HEIGHT];
+            int slot[MAX_HEIGHT], height;
+            page_id p = descend(value.first, path, slot, height);
+            int i = leaf_lower(leaf(p), value.first);
+            if (i < leaf(p)->h.cnt && !com(value.first, leaf(p)->data[i].first))
+                return pair<iterator, bool>(iterator(p, i, this), false);
+            p = insert_at(path, slot, height, p, i, value, i);
+            return pair<iterator, bool>(iterator(p, i, this), true);
+        }
+        void erase(iterator pos) {
+            if (pos.it != this || pos.page == 0) throw index_out_of_bound();
+            page_id path[MAX_HEIGHT];
+            int slot[MAX_HEIGHT], height;
+            page_id p = descend(pos->first, path, slot, height);
+            if (p != pos.page) throw invalid_iterator();
+            leaf_node *q = leaf(p);
+            touch(p);
+            memmove((void*) (q->data + pos.index), q->data + pos.index + 1, (q->h.cnt - pos.index - 1) * sizeof(value_type));
+            --q->h.cnt;
+            --meta()->len;
+            if (q->h.cnt > 0 || height == 0) return;
+            if (q->h.prev != 0) {
+                leaf(q->h.prev)->h.next = q->h.next;
+                touch(q->h.prev);
+            }
+            else meta()->first = q->h.next;
+            if (q->h.next != 0) {
+                leaf(q->h.next)->h.prev = q->h.prev;
+                touch(q->h.next);
+            }
+            else meta()->last = q->h.prev;
+            release(p);
+            remove_child(path, slot, height);
+        }
+        size_t count(const Key &key) const {
+            page_id p;
+            int i;
+            return locate(key, p, i) ? 1 : 0;
+        }
+        iterator find(const Key &key) {
+            page_id p;
+            int i;
+            if (!locate(key, p, i)) return end();
+            return iterator(p, i, this);
+        }
+        const_iterator find(const Key &key) const {
+            page_id p;
+            int i;
+            if (!locate(key, p, i)) return cend();
+            return const_iterator(p, i, this);
+        }
+        iterator lower_bound(const Key &key) {
+            page_id p;
+            int i;
+            locate(key, p, i);
+            if (i == leaf(p)->h.cnt) {
+                p = leaf(p)->h.next;
+                i = 0;
+            }
+            return iterator(p, i, this);
+        }
+        const_iterator lower_bound(const Key &key) const {
+            page_id p;
+            int i;
+            locate(key, p, i);
+            if (i == leaf(p)->h.cnt) {
+                p = leaf(p)->h.next;
+                i = 0;
+            }
+            return const_iterator(p, i, this);
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,457 @@
+/**
+ * implement a map from closed intervals to values that answers overlap queries
+ */
+#ifndef SJTU_INTERVAL_MAP_HPP
+#define SJTU_INTERVAL_MAP_HPP
+
+#include <functional>
+#include <cstddef>
+#include <cmath>
+#include <utility>
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+    /**
+     * Intervals [first, second] are ordered by start, then by end. Every node also keeps the largest
+     * end point in its subtree, so a query skips any subtree that ends before it begins.
+     * The tree is a scapegoat tree: a subtree that gets too deep is flattened and rebuilt perfectly
+     * balanced, which keeps the height O(log n) without any rotation.
+     */
+    template<
+            class Key,
+            class T,
+            class Compare = std::less<Key>
+    > class interval_map {
+    public:
+        typedef pair<Key, Key> interval_type;
+        typedef pair<const interval_type, T> value_type;
+        struct node {
+            value_type data;
+            Key max;
+            node* left;
+            node* right;
+            node* father;
+            node (node *other, node *f):data(other->data), max(other->max) {
+                if (other->left != nullptr) left = new node (other->left, this);
+                else left = nullptr;
+                if (other->right != nullptr) right = new node (other->right, this);
+                else right = nullptr;
+                father = f;
+            }
+            node (const value_type &val, node *f):data(val), max(val.first.second) {
+                left = nullptr;
+                right = nullptr;
+                father = f;
+            }
+        };
+        node *root;
+        int len, max_len;
+        Compare com;
+
+        bool less(const interval_type &a, const interval_type &b) const {
+            if (com(a.first, b.first)) return true;
+            if (com(b.first, a.first)) return false;
+            return com(a.second, b.second);
+        }
+        void del(node *tmp) {
+            if (tmp == nullptr) return;
+            del(tmp->left);
+            del(tmp->right);
+            delete tmp;
+        }
+        int count_nodes(node *tmp) const {
+            if (tmp == nullptr) return 0;
+            return 1 + count_nodes(tmp->left) + count_nodes(tmp->right);
+        }
+        void pull(node *p) {
+            p->max = p->data.first.second;
+            if (p->left != nullptr && com(p->max, p->left->max)) p->max = p->left->max;
+            if (p->right != nullptr && com(p->max, p->right->max)) p->max = p->right->max;
+        }
+        node *search(const interval_type &k) const {
+            node *tmp = root;
+            while (tmp != nullptr) {
+                if (less(k, tmp->data.first)) tmp = tmp->left;
+                else if (less(tmp->data.first, k)) tmp = tmp->right;
+                else break;
+            }
+            return tmp;
+        }
+        node *findnext (node *p) const {
+            if (p == nullptr) throw invalid_iterator();
+            if (p->right != nullptr) {
+                p = p->right;
+                while (p->left != nullptr) p = p->left;
+                return p;
+            }
+            while (p->father != nullptr) {
+                if (p == p->father->left) return p->father;
+                p = p->father;
+            }
+            return nullptr;
+        }
+        node *findlast (node *p) const {
+            if (p == nullptr) {
+                p = root;
+                if (p == nullptr) throw invalid_iterator();
+                while (p->right != nullptr) p = p->right;
+                return p;
+            }
+            else if (p->left != nullptr) {
+                p = p->left;
+                while (p->right != nullptr) p = p->right;
+                return p;
+            }
+            while (p->father != nullptr) {
+                if (p == p->father->right) return p->father;
+                p = p->father;
+            }
+            throw invalid_iterator();
+        }
+        /**
+         * link the subtree t in order into a vine through right
+         */
+        void flatten(node *t, node **&tail) {
+            if (t == nullptr) return;
+            flatten(t->left, tail);
+            node *r = t->right;
+            *tail = t;
+            tail = &t->right;
+            flatten(r, tail);
+        }
+        node *build(node *&vine, int n, node *fa) {
+            if (n == 0) return nullptr;
+            node *l = build(vine, n / 2, nullptr);
+            node *ret = vine;
+            vine = vine->right;
+            ret->left = l;
+            if (l != nullptr) l->father = ret;
+            ret->father = fa;
+            ret->right = build(vine, n - n / 2 - 1, ret);
+            pull(ret);
+            return ret;
+        }
+        void rebuild(node *t, int n) {
+            node *fa = t->father;
+            bool is_left = fa != nullptr && fa->left == t;
+            node *vine = nullptr, **tail = &vine;
+            flatten(t, tail);
+            *tail = nullptr;
+            t = build(vine, n, fa);
+            if (fa == nullptr) root = t;
+            else if (is_left) fa->left = t;
+            else fa->right = t;
+        }
+        void replace(node *u, node *v) {
+            if (u->father == nullptr) root = v;
+            else if (u == u->father->left) u->father->left = v;
+            else u->father->right = v;
+            if (v != nullptr) v->father = u->father;
+        }
+        int height_limit() const {
+            return (int) (std::log((double) len) / std::log(1.5));
+        }
+        template<class F>
+        void overlap(node *t, const Key &lo, const Key &hi, F &f) const {
+            while (t != nullptr && !com(t->max, lo)) {
+                overlap(t->left, lo, hi, f);
+                if (com(hi, t->data.first.first)) return;
+                if (!com(t->data.first.second, lo)) f(t->data);
+                t = t->right;
+            }
+        }
+        class const_iterator;
+        class iterator {
+        private:
+            friend const_iterator;
+        public:
+            node *pos;
+            interval_map *it;
+            iterator(node *obj1 = nullptr, interval_map *obj2 = nullptr) {
+                pos = obj1;
+                it = obj2;
+            }
+            iterator operator++(int) {
+                node *tmp = pos;
+                pos = it->findnext(pos);
+                return iterator(tmp, it);
+            }
+            iterator & operator++() {
+                pos = it->findnext(pos);
+                return *this;
+            }
+            iterator operator--(int) {
+                node *tmp = pos;
+                pos = it->findlast(pos);
+                return iterator(tmp, it);
+            }
+            iterator & operator--() {
+                pos = it->findlast(pos);
+                return *this;
+            }
+            value_type & operator*() const {
+                return pos->data;
+            }
+            bool operator==(const iterator &rhs) const {
+                return pos == rhs.pos && it == rhs.it;
+            }
+            bool operator==(const const_iterator &rhs) const {
+                return pos == rhs.pos && it == rhs.it;
+            }
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+            value_type* operator->() const noexcept {
+                return &(pos->data);
+            }
+        };
+        class const_iterator {
+        private:
+            friend iterator;
+        public:
+            node *pos;
+            const interval_map *it;
+            const_iterator(node *obj1 = nullptr, const interval_map *obj2 = nullptr) {
+                pos = obj1;
+                it = obj2;
+            }
+            const_iterator(const iterator &other) {
+                pos = other.pos;
+                it = other.it;
+            }
+            const_iterator operator++(int) {
+                node *tmp = pos;
+                pos = it->findnext(pos);
+                return const_iterator(tmp, it);
+            }
+            const_iterator & operator++() {
+                pos = it->findnext(pos);
+                return *this;
+            }
+            const_iterator operator--(int) {
+                node *tmp = pos;
+                pos = it->findlast(pos);
+                return const_iterator(tmp, it);
+            }
+            const_iterator & operator--() {
+                pos = it->findlast(pos);
+                return *this;
+            }
+            const value_type & operator*() const {
+                return pos->data;
+            }
+            bool operator==(const iterator &rhs) const {
+                return pos == rhs.pos && it == rhs.it;
+            }
+            bool operator==(const const_iterator &rhs) const {
+                return pos == rhs.pos && it == rhs.it;
+            }
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+            const value_type* operator->() const noexcept {
+                return &(pos->data);
+            }
+        };
+        interval_map() {
+            root = nullptr;
+            len = max_len = 0;
+        }
+        /**
+         * bulk construction in O(n) from intervals given in increasing order,
+         * falling back to one insertion per element if they are not
+         */
+        template<class InputIt>
+        interval_map(InputIt first, InputIt last) {
+            root = nullptr;
+            len = max_len = 0;
+            node *vine = nullptr, **tail = &vine, *prev = nullptr;
+            for (; first != last; ++first) {
+                if (prev != nullptr && !less(prev->data.first, (*first).first)) {
+                    *tail = nullptr;
+                    root = build(vine, len, nullptr);
+                    max_len = len;
+                    for (; first != last; ++first) insert(*first);
+                    return;
+                }
+                prev = new node(*first, nullptr);
+                *tail = prev;
+                tail = &prev->right;
+                ++len;
+            }
+            *tail = nullptr;
+            root = build(vine, len, nullptr);
+            max_len = len;
+        }
+        interval_map(const interval_map &other) {
+            len = max_len = other.len;
+            root = other.root == nullptr ? nullptr : new node(other.root, nullptr);
+        }
+        interval_map & operator=(const interval_map &other) {
+            if (this == &other) return *this;
+            clear();
+            len = max_len = other.len;
+            root = other.root == nullptr ? nullptr : new node(other.root, nullptr);
+            return *this;
+        }
+        interval_map(interval_map &&other) noexcept: root(other.root), len(other.len), max_len(other.max_len), com(other.com) {
+            other.root = nullptr;
+            other.len = other.max_len = 0;
+        }
+        interval_map & operator=(interval_map &&other) noexcept {
+            if (this == &other) return *this;
+            clear();
+            swap(other);
+            return *this;
+        }
+        void swap(interval_map &other) noexcept {
+            std::swap(root, other.root);
+            std::swap(len, other.len);
+            std::swap(max_len, other.max_len);
+            std::swap(com, other.com);
+        }
+        ~interval_map() {
+            clear();
+        }
+        T & at(const interval_type &key) {
+            node *tmp = search(key);
+            if (tmp == nullptr) throw index_out_of_bound();
+            return tmp->data.second;
+        }
+        const T & at(const interval_type &key) const {
+            node *tmp = search(key);
+            if (tmp == nullptr) throw index_out_of_bound();
+            return tmp->data.second;
+        }
+        iterator begin() {
+            if (len == 0) return iterator(nullptr, this);
+            node *tmp = root;
+            while (tmp->left != nullptr) tmp = tmp->left;
+            return iterator(tmp, this);
+        }
+        const_iterator cbegin() const {
+            if (len == 0) return const_iterator(nullptr, this);
+            node *tmp = root;
+            while (tmp->left != nullptr) tmp = tmp->left;
+            return const_iterator(tmp, this);
+        }
+        iterator end() {
+            return iterator(nullptr, this);
+        }
+        const_iterator cend() const {
+            return const_iterator(nullptr, this);
+        }
+        bool empty() const {
+            return len == 0;
+        }
+        size_t size() const {
+            return len;
+        }
+        void clear() {
+            del(root);
+            root = nullptr;
+            len = max_len = 0;
+        }
+        pair<iterator, bool> insert(const value_type &value) {
+            if (com(value.first.second, value.first.first)) throw runtime_error();
+            node *fa = nullptr, *tmp = root;
+            int depth = 0;
+            while (tmp != nullptr) {
+                fa = tmp;
+                if (less(value.first, tmp->data.first)) tmp = tmp->left;
+                else if (less(tmp->data.first, value.first)) tmp = tmp->right;
+                else return pair<iterator, bool>(iterator(tmp, this), false);
+                ++depth;
+            }
+            node *ret = new node(value, fa);
+            if (fa == nullptr) root = ret;
+            else if (less(value.first, fa->data.first)) fa->left = ret;
+            else fa->right = ret;
+            ++len;
+            if (len > max_len) max_len = len;
+            for (tmp = fa; tmp != nullptr; tmp = tmp->father) pull(tmp);
+            if (depth > height_limit()) {
+                int size = 1;
+                for (tmp = ret; tmp->father != nullptr; tmp = tmp->father) {
+                    node *p = tmp->father;
+                    int total = size + 1 + count_nodes(p->left == tmp ? p->right : p->left);
+                    if (3 * size > 2 * total) {
+                        rebuild(p, total);
+                        break;
+                    }
+                    size = total;
+                }
+            }
+            return pair<iterator, bool>(iterator(ret, this), true);
+        }
+        void erase(iterator pos) {
+            node *tmp = pos.pos, *fix;
+            if (tmp == nullptr || this != pos.it) throw index_out_of_bound();
+            if (tmp->left == nullptr || tmp->right == nullptr) {
+                replace(tmp, tmp->left != nullptr ? tmp->left : tmp->right);
+                fix = tmp->father;
+            }
+            else {
+                node *rep = tmp->right;
+                while (rep->left != nullptr) rep = rep->left;
+                if (rep->father != tmp) {
+                    fix = rep->father;
+                    replace(rep, rep->right);
+                    rep->right = tmp->right;
+                    rep->right->father = rep;
+                }
+                else fix = rep;
+                replace(tmp, rep);
+                rep->left = tmp->left;
+                rep->left->father = rep;
+            }
+            delete tmp;
+            --len;
+            for (; fix != nullptr; fix = fix->father) pull(fix);
+            if (root != nullptr && 3 * len < 2 * max_len) {
+                rebuild(root, len);
+                max_len = len;
+            }
+        }
+        size_t count(const interval_type &key) const {
+            return search(key) == nullptr ? 0 : 1;
+        }
+        iterator find(const interval_type &key) {
+            return iterator(search(key), this);
+        }
+        const_iterator find(const interval_type &key) const {
+            return const_iterator(search(key), this);
+        }
+        /**
+         * call f on every interval sharing a point with [lo, hi], in increasing order;
+         * only subtrees holding a result are entered, so this is O(log n) per result and O(log n) for none
+         */
+        template<class F>
+        void overlap(const Key &lo, const Key &hi, F f) const {
+            overlap(root, lo, hi, f);
+        }
+        /**
+         * call f on every interval containing x
+         */
+        template<class F>
+        void stab(const Key &x, F f) const {
+            overlap(root, x, x, f);
+        }
+    };
+
+    template<class Key, class T, class Compare>
+    void swap(interval_map<Key, T, Compare> &a, interval_map<Key, T, Compare> &b) noexcept {
+        a.swap(b);
+    }
+
+}
+
+#endif
@@ -0,0 +1,218 @@
+/**
+ * implement a fixed-capacity least-recently-used cache on top of sjtu::map
+ */
+#ifndef SJTU_LRU_CACHE_HPP
+#define SJTU_LRU_CACHE_HPP
+
+#include <functional>
+#include <cstddef>
+#include <utility>
+#include "map1.hpp"
+
+namespace sjtu {
+
+    /**
+     * The recency list is threaded through the map's own nodes: each mapped slot carries the links,
+     * so a hit is one lookup plus a few pointer writes and allocates nothing.
+     * Only a put of a new key allocates, and a full cache first frees its least recently used entry.
+     * The index is a splaying map, so lookups stay O(log n) amortized even when the keys come in order,
+     * which would leave a plain unbalanced tree as deep as the cache is large.
+     */
+    template<
+            class Key,
+            class T,
+            class Compare = std::less<Key>
+    > class lru_cache {
+    public:
+        struct slot {
+            T value;
+            void *prev, *next;
+            slot(const T &v): value(v), prev(nullptr), next(nullptr) {}
+        };
+        typedef map<Key, slot, Compare, true> index_type;
+        typedef typename index_type::node node;
+        typedef std::function<void (const Key &, T &)> evict_type;
+
+        index_type index;
+        node *head, *tail;
+        size_t cap;
+        size_t hit, miss;
+        evict_type on_evict;
+
+        static slot &links(node *p) {
+            return p->data.second;
+        }
+        void unlink(node *p) {
+            node *prev = (node*) links(p).prev, *next = (node*) links(p).next;
+            if (prev != nullptr) links(prev).next = next;
+            else head = next;
+            if (next != nullptr) links(next).prev = prev;
+            else tail = prev;
+        }
+        void push_front(node *p) {
+            links(p).prev = nullptr;
+            links(p).next = head;
+            if (head != nullptr) links(head).prev = p;
+            else tail = p;
+            head = p;
+        }
+        /**
+         * the node of key splayed to the root, or nullptr
+         */
+        node *find(const Key &key) {
+            return index.access(index.search(key));
+        }
+        /**
+         * Take p out of the index. Splaying p and then its successor to the root leaves p as a
+         * left child with no right subtree, so unlinking it does not deepen the tree.
+         */
+        void remove(node *p) {
+            index.access(p);
+            node *q = p->right;
+            if (q != nullptr) {
+                while (q->left != nullptr) q = q->left;
+                index.access(q);
+            }
+            index.erase(typename index_type::iterator(p, &index));
+        }
+        void evict() {
+            node *p = tail;
+            unlink(p);
+            if (on_evict) on_evict(p->data.first, links(p).value);
+            remove(p);
+        }
+        void copy(const lru_cache &other) {
+            head = tail = nullptr;
+            cap = other.cap;
+            hit = other.hit;
+            miss = other.miss;
+            on_evict = other.on_evict;
+            for (node *p = other.tail; p != nullptr; p = (node*) links(p).prev) put(p->data.first, links(p).value);
+        }
+        explicit lru_cache(size_t capacity) {
+            head = tail = nullptr;
+            cap = capacity > 0 ? capacity : 1;
+            hit = miss = 0;
+        }
+        lru_cache(const lru_cache &other) {
+            copy(other);
+        }
+        lru_cache & operator=(const lru_cache &other) {
+            if (this == &other) return *this;
+            index.clear();
+            copy(other);
+            return *this;
+        }
+        /**
+         * the entries keep their nodes, so the recency list moves over as it is
+         */
+        lru_cache(lru_cache &&other) noexcept: index(std::move(other.index)), head(other.head), tail(other.tail),
+                cap(other.cap), hit(other.hit), miss(other.miss), on_evict(std::move(other.on_evict)) {
+            other.head = other.tail = nullptr;
+            other.hit = other.miss = 0;
+        }
+        lru_cache & operator=(lru_cache &&other) noexcept {
+            if (this == &other) return *this;
+            index.clear();
+            head = tail = nullptr;
+            swap(other);
+            return *this;
+        }
+        void swap(lru_cache &other) noexcept {
+            index.swap(other.index);
+            std::swap(head, other.head);
+            std::swap(tail, other.tail);
+            std::swap(cap, other.cap);
+            std::swap(hit, other.hit);
+            std::swap(miss, other.miss);
+            on_evict.swap(other.on_evict);
+        }
+        /**
+         * the cached value for key, marked as most recently used, or nullptr on a miss
+         */
+        T *get(const Key &key) {
+            node *p = find(key);
+            if (p == nullptr) {
+                ++miss;
+                return nullptr;
+            }
+            ++hit;
+            if (p != head) {
+                unlink(p);
+                push_front(p);
+            }
+            return &links(p).value;
+        }
+        /**
+         * look key up without touching its recency or the counters
+         */
+        const T *peek(const Key &key) const {
+            node *p = index.search(key);
+            return p == nullptr ? nullptr : &links(p).value;
+        }
+        void put(const Key &key, const T &value) {
+            node *p = find(key);
+            if (p != nullptr) {
+                links(p).value = value;
+                if (p != head) {
+                    unlink(p);
+                    push_front(p);
+                }
+                return;
+            }
+            if (index.size() >= cap) evict();
+            p = index.insert(typename index_type::value_type(key, slot(value))).first.pos;
+            push_front(p);
+        }
+        bool erase(const Key &key) {
+            node *p = find(key);
+            if (p == nullptr) return false;
+            unlink(p);
+            remove(p);
+            return true;
+        }
+        bool contains(const Key &key) const {
+            return index.count(key) != 0;
+        }
+        /**
+         * shrinking below the current size evicts the least recently used entries
+         */
+        void set_capacity(size_t capacity) {
+            cap = capacity > 0 ? capacity : 1;
+            while (index.size() > cap) evict();
+        }
+        void set_evict_callback(const evict_type &f) {
+            on_evict = f;
+        }
+        void clear() {
+            index.clear();
+            head = tail = nullptr;
+        }
+        size_t size() const {
+            return index.size();
+        }
+        bool empty() const {
+            return index.empty();
+        }
+        size_t capacity() const {
+            return cap;
+        }
+        size_t hits() const {
+            return hit;
+        }
+        size_t misses() const {
+            return miss;
+        }
+        void reset_counters() {
+            hit = miss = 0;
+        }
+    };
+
+    template<class Key, class T, class Compare>
+    void swap(lru_cache<Key, T, Compare> &a, lru_cache<Key, T, Compare> &b) noexcept {
+        a.swap(b);
+    }
+
+}
+
+#endif
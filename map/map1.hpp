@@ -7,60 +7,249 @@
 // only for std::less<T>
 #include <functional>
 #include <cstddef>
+#include <utility>
 #include "utility.hpp"
 #include "exceptions.hpp"
+#include "value_arena.hpp"
 
 namespace sjtu {
 
+    /**
+     * how a map node holds its element: in the node itself by default
+     */
+    template<class Key, class T, bool Separate>
+    struct map_storage {
+        typedef pair<const Key, T> value_type;
+        struct arena {
+            void swap(arena &) noexcept {}
+        };
+        value_type data;
+        map_storage(const value_type &val, arena &):data(val) {}
+        const Key & key() const {
+            return data.first;
+        }
+        void release(arena &) {}
+    };
+    /**
+     * or as a copy of the key next to a reference into the map's value arena, which keeps nodes small
+     * whatever the size of T, and leaves each element at one address for as long as it is in the map
+     */
+    template<class Key, class T>
+    struct map_storage<Key, T, true> {
+        typedef pair<const Key, T> value_type;
+        typedef value_arena<value_type> arena;
+        Key k;
+        value_type &data;
+        map_storage(const value_type &val, arena &a):k(val.first), data(*a.make(val)) {}
+        const Key & key() const {
+            return k;
+        }
+        void release(arena &a) {
+            a.destroy(&data);
+        }
+    };
+
+    /**
+     * with Splay set, every non-const lookup or insertion splays the node it reaches to the root,
+     * so frequently accessed keys stay near the top of the tree;
+     * with Separate set, elements are kept out of the nodes (see map_storage), so searches only touch
+     * keys and links, which pays off when T is large
+     */
     template<
             class Key,
             class T,
-            class Compare = std::less<Key>
+            class Compare = std::less<Key>,
+            bool Splay = false,
+            bool Separate = false
     > class map {
     public:
         typedef pair<const Key, T> value_type;
-        struct node {
-            value_type data;
+        typedef map_storage<Key, T, Separate> storage;
+        typedef typename storage::arena arena_type;
+        struct node : storage {
             node* left;
             node* right;
             node* father;
-            node (node *other, node *f):data(other->data) {
-                if (other->left != nullptr) left = new node (other->left, this);
+            int cnt;
+            node (node *other, node *f, arena_type &a):storage(other->data, a), cnt(other->cnt) {
+                if (other->left != nullptr) left = new node (other->left, this, a);
                 else left = nullptr;
-                if (other->right != nullptr) right = new node (other->right, this);
+                if (other->right != nullptr) right = new node (other->right, this, a);
                 else right = nullptr;
                 father = f;
             }
-            node (Key k, T t, node *f):data(k, t) {
+            node (Key k, T t, node *f, arena_type &a):storage(value_type(k, t), a), cnt(1) {
                 left = nullptr;
                 right = nullptr;
                 father = f;
             }
-            node (const value_type &val, node *f):data(val){
+            node (const value_type &val, node *f, arena_type &a):storage(val, a), cnt(1) {
                 left = nullptr;
                 right = nullptr;
                 father = f;
             }
         };
+        arena_type pool;
         node *root;
+        /**
+         * the first and last nodes in order, kept so that begin() and --end() are O(1)
+         */
+        node *leftmost, *rightmost;
         int len;
         Compare com;
-        void del(node *tmp) {
-            if (tmp == nullptr) return;
-            if (tmp->left != nullptr) del(tmp->left);
-            if (tmp->right != nullptr) del(tmp->right);
+        void drop(node *tmp) {
+            tmp->release(pool);
             delete tmp;
         }
+        int del(node *tmp) {
+            if (tmp == nullptr) return 0;
+            int ret = 1;
+            if (tmp->left != nullptr) ret += del(tmp->left);
+            if (tmp->right != nullptr) ret += del(tmp->right);
+            drop(tmp);
+            return ret;
+        }
+        /**
+         * remove the keys in [lo, hi) from the subtree t (a null bound is unbounded) and return what is left,
+         * only the two boundary paths are walked and fully covered subtrees are freed as a whole
+         */
+        node *trim(node *t, node *fa, const Key *lo, const Key *hi, int &cnt) {
+            if (t == nullptr) return nullptr;
+            if (lo != nullptr && com(t->key(), *lo)) t->right = trim(t->right, t, lo, hi, cnt);
+            else if (hi != nullptr && !com(t->key(), *hi)) t->left = trim(t->left, t, lo, hi, cnt);
+            else if (lo == nullptr && hi == nullptr) {
+                cnt += del(t);
+                return nullptr;
+            }
+            else {
+                node *l = trim(t->left, fa, lo, nullptr, cnt);
+                node *r = trim(t->right, fa, nullptr, hi, cnt);
+                drop(t);
+                ++cnt;
+                if (l == nullptr) return r;
+                if (r != nullptr) {
+                    node *tmp = l;
+                    for (; tmp->right != nullptr; tmp = tmp->right) tmp->cnt += r->cnt;
+                    tmp->cnt += r->cnt;
+                    tmp->right = r;
+                    r->father = tmp;
+                }
+                return l;
+            }
+            t->father = fa;
+            pull(t);
+            return t;
+        }
+        /**
+         * build a perfectly balanced tree from the first n nodes of a vine linked through right
+         */
+        node *build(node *&vine, int n, node *fa) {
+            if (n == 0) return nullptr;
+            node *l = build(vine, n / 2, nullptr);
+            node *ret = vine;
+            vine = vine->right;
+            ret->left = l;
+            if (l != nullptr) l->father = ret;
+            ret->father = fa;
+            ret->right = build(vine, n - n / 2 - 1, ret);
+            ret->cnt = n;
+            return ret;
+        }
+        static int size(node *t) {
+            return t == nullptr ? 0 : t->cnt;
+        }
+        static void pull(node *t) {
+            t->cnt = size(t->left) + size(t->right) + 1;
+        }
+        /**
+         * count one more (d = 1) or one less (d = -1) node in t and all its ancestors
+         */
+        static void adjust(node *t, int d) {
+            for (; t != nullptr; t = t->father) t->cnt += d;
+        }
+        /**
+         * recompute leftmost and rightmost after an update that reshapes the whole tree
+         */
+        void fix_ends() {
+            leftmost = rightmost = root;
+            if (root == nullptr) return;
+            while (leftmost->left != nullptr) leftmost = leftmost->left;
+            while (rightmost->right != nullptr) rightmost = rightmost->right;
+        }
+        /**
+         * a new leaf p becomes leftmost or rightmost exactly when it hangs off the old one on that side
+         */
+        void hang(node *p) {
+            if (p->father == leftmost && p == leftmost->left) leftmost = p;
+            if (p->father == rightmost && p == rightmost->right) rightmost = p;
+        }
         node *search (const Key &k) const {
             if (len == 0) return nullptr;
             node *tmp = root;
             while (tmp != nullptr) {
-                if (com(k, tmp->data.first)) tmp = tmp->left;
-                else if (com(tmp->data.first, k)) tmp = tmp->right;
+                if (com(k, tmp->key())) tmp = tmp->left;
+                else if (com(tmp->key(), k)) tmp = tmp->right;
                 else break;
             }
             return tmp;
         }
+        void rotate(node *x) {
+            node *y = x->father, *z = y->father;
+            if (x == y->left) {
+                y->left = x->right;
+                if (x->right != nullptr) x->right->father = y;
+                x->right = y;
+            }
+            else {
+                y->right = x->left;
+                if (x->left != nullptr) x->left->father = y;
+                x->left = y;
+            }
+            y->father = x;
+            x->father = z;
+            pull(y);
+            pull(x);
+            if (z == nullptr) root = x;
+            else if (z->left == y) z->left = x;
+            else z->right = x;
+        }
+        void splay(node *x) {
+            while (x->father != nullptr) {
+                node *y = x->father, *z = y->father;
+                if (z != nullptr) rotate((x == y->left) == (y == z->left) ? y : x);
+                rotate(x);
+            }
+        }
+        node *access(node *x) {
+            if (Splay && x != nullptr) splay(x);
+            return x;
+        }
+        /**
+         * the node of rank k (counting from 0), or nullptr if k >= len
+         */
+        node *select(int k) const {
+            node *t = root;
+            while (t != nullptr) {
+                int l = size(t->left);
+                if (k < l) t = t->left;
+                else if (k == l) return t;
+                else {
+                    k -= l + 1;
+                    t = t->right;
+                }
+            }
+            return nullptr;
+        }
+        /**
+         * the number of nodes before p, where nullptr stands for end
+         */
+        int rank(node *p) const {
+            if (p == nullptr) return len;
+            int ret = size(p->left);
+            for (; p->father != nullptr; p = p->father)
+                if (p == p->father->right) ret += size(p->father->left) + 1;
+            return ret;
+        }
         node *findnext (node *p) const {
             if (p == nullptr) throw invalid_iterator();
             if (p->right != nullptr) {
@@ -76,10 +265,8 @@ namespace sjtu {
         }
         node *findlast (node *p) const {
             if (p == nullptr) {
-                p = root;
-                if (p == nullptr) throw invalid_iterator();
-                while (p->right != nullptr) p = p->right;
-                return p;
+                if (rightmost == nullptr) throw invalid_iterator();
+                return rightmost;
             }
             else if (p->left != nullptr) {
                 p = p->left;
@@ -107,6 +294,7 @@ namespace sjtu {
                 pos = other.pos;
                 it = other.it;
             }
+            iterator & operator=(const iterator &other) = default;
             iterator(node *obj1, map *obj2) {
                 pos = obj1;
                 it = obj2;
@@ -166,6 +354,7 @@ namespace sjtu {
                 pos = other.pos;
                 it = other.it;
             }
+            const_iterator & operator=(const const_iterator &other) = default;
             const_iterator(const iterator &other) {
                 pos = other.pos;
                 it = other.it;
@@ -216,32 +405,57 @@ namespace sjtu {
             }
         };
         map() {
-            root = nullptr;
+            root = leftmost = rightmost = nullptr;
             len = 0;
         }
         map(const map &other) {
             len = other.len;
             node *tmp;
-            if (other.root != nullptr) tmp = new node (other.root, nullptr);
+            if (other.root != nullptr) tmp = new node (other.root, nullptr, pool);
             else tmp = nullptr;
             root = tmp;
             tmp = nullptr;
+            fix_ends();
         }
         map & operator=(const map &other) {
             if (this == &other) return *this;
             clear();
             len = other.len;
             node *tmp;
-            if (other.root != nullptr) tmp = new node (other.root, nullptr);
+            if (other.root != nullptr) tmp = new node (other.root, nullptr, pool);
             else tmp = nullptr;
             root = tmp;
             tmp = nullptr;
+            fix_ends();
+            return *this;
+        }
+        /**
+         * takes other's tree, and its value arena with it; other is left empty
+         */
+        map(map &&other) noexcept: root(other.root), leftmost(other.leftmost), rightmost(other.rightmost), len(other.len), com(other.com) {
+            pool.swap(other.pool);
+            other.root = other.leftmost = other.rightmost = nullptr;
+            other.len = 0;
+        }
+        map & operator=(map &&other) noexcept {
+            if (this == &other) return *this;
+            clear();
+            swap(other);
+            return *this;
+        }
+        void swap(map &other) noexcept {
+            pool.swap(other.pool);
+            std::swap(root, other.root);
+            std::swap(leftmost, other.leftmost);
+            std::swap(rightmost, other.rightmost);
+            std::swap(len, other.len);
+            std::swap(com, other.com);
         }
         ~map() {
             clear();
         }
         T & at(const Key &key) {
-            node *tmp = search(key);
+            node *tmp = access(search(key));
             if (tmp == nullptr) throw index_out_of_bound();
             return tmp->data.second;
         }
@@ -251,26 +465,28 @@ namespace sjtu {
             return tmp->data.second;
         }
         T & operator[](const Key &key) {
-            node *tmp = search(key);
+            node *tmp = access(search(key));
             if (tmp == nullptr) {
                 ++len;
                 value_type t(key, T());
                 if (root == nullptr) {
-                    root = new node(t, nullptr);
+                    root = leftmost = rightmost = new node(t, nullptr, pool);
                     return root->data.second;
                 }
                 tmp = root;
                 node *fa;
                 while (tmp != nullptr) {
                     fa = tmp;
-                    if (com(key, tmp->data.first)) tmp = tmp->left;
-                    else if (com(tmp->data.first, key)) tmp = tmp->right;
+                    if (com(key, tmp->key())) tmp = tmp->left;
+                    else if (com(tmp->key(), key)) tmp = tmp->right;
                 }
-                node *ret = new node(t, fa);
+                node *ret = new node(t, fa, pool);
                 ret->father = fa;
-                if (com(key, fa->data.first)) fa->left = ret;
+                if (com(key, fa->key())) fa->left = ret;
                 else fa->right = ret;
-                return ret->data.second;
+                adjust(fa, 1);
+                hang(ret);
+                return access(ret)->data.second;
             }
             return tmp->data.second;
         }
@@ -280,16 +496,10 @@ namespace sjtu {
             return tmp->data.second;
         }
         iterator begin() {
-            if (len == 0) return iterator(nullptr, this);
-            node *tmp = root;
-            while (tmp->left != nullptr) tmp = tmp->left;
-            return iterator(tmp, this);
+            return iterator(leftmost, this);
         }
         const_iterator cbegin() const {
-            if (len == 0) return const_iterator(nullptr, this);
-            node *tmp = root;
-            while (tmp->left != nullptr) tmp = tmp->left;
-            return const_iterator(tmp, this);
+            return const_iterator(leftmost, this);
         }
         iterator end() {
             return iterator(nullptr, this);
@@ -307,7 +517,7 @@ namespace sjtu {
         void clear() {
             del(root);
             len = 0;
-            root = nullptr;
+            root = leftmost = rightmost = nullptr;
         }
         pair<iterator, bool> insert(const value_type &value) {
             node *tmp = search(value.first);
@@ -315,7 +525,7 @@ namespace sjtu {
             bool ret2;
             if (tmp == nullptr) {
                 if (len == 0) {
-                    root = new node(value, nullptr);
+                    root = leftmost = rightmost = new node(value, nullptr, pool);
                     ret1.pos = root;
                     ret1.it = this;
                     ret2 = true;
@@ -326,21 +536,23 @@ namespace sjtu {
                 node *fa;
                 while (tmp != nullptr) {
                     fa = tmp;
-                    if (com(value.first, tmp->data.first)) tmp = tmp->left;
-                    else if (com(tmp->data.first, value.first)) tmp = tmp->right;
+                    if (com(value.first, tmp->key())) tmp = tmp->left;
+                    else if (com(tmp->key(), value.first)) tmp = tmp->right;
                 }
-                node *ret = new node(value, fa);
+                node *ret = new node(value, fa, pool);
                 ret->father = fa;
-                if (com(value.first, fa->data.first)) fa->left = ret;
+                if (com(value.first, fa->key())) fa->left = ret;
                 else fa->right = ret;
-                ret1.pos = ret;
+                adjust(fa, 1);
+                hang(ret);
+                ret1.pos = access(ret);
                 ret1.it = this;
                 ret2 = true;
                 ++len;
                 return pair<iterator, bool>(ret1, ret2);
             }
             else {
-                ret1.pos = tmp;
+                ret1.pos = access(tmp);
                 ret1.it = this;
                 ret2 = false;
                 return pair<iterator, bool>(ret1, ret2);
@@ -349,6 +561,9 @@ namespace sjtu {
         void erase(iterator pos) {
             node *tmp = pos.pos;
             if (tmp == nullptr || this != pos.it) throw index_out_of_bound();
+            adjust(tmp->father, -1);
+            if (tmp == leftmost) leftmost = findnext(tmp);
+            if (tmp == rightmost) rightmost = len == 1 ? nullptr : findlast(tmp);
             if (tmp->left == nullptr) {
                 if (tmp == root) root = tmp->right;
                 else if (tmp == tmp->father->left) tmp->father->left = tmp->right;
@@ -364,6 +579,7 @@ namespace sjtu {
             else {
                 node *rep = tmp->right;
                 while (rep->left != nullptr) rep = rep->left;
+                for (node *p = rep; p != tmp; p = p->father) p->cnt += tmp->left->cnt;
                 rep->left = tmp->left;
                 rep->left->father = rep;
                 if (tmp == root) root = tmp->right;
@@ -371,16 +587,68 @@ namespace sjtu {
                 else tmp->father->right = tmp->right;
                 if (tmp->right != nullptr) tmp->right->father = tmp->father;
             }
-            delete tmp;
+            drop(tmp);
             --len;
         }
+        size_t erase(const Key &key) {
+            node *tmp = search(key);
+            if (tmp == nullptr) return 0;
+            erase(iterator(tmp, this));
+            return 1;
+        }
+        /**
+         * remove [first, last) in one pass over the boundary paths
+         */
+        iterator erase(iterator first, iterator last) {
+            if (first.it != this || last.it != this) throw invalid_iterator();
+            if (first == last) return last;
+            if (first.pos == nullptr) throw invalid_iterator();
+            Key lo(first.pos->key());
+            int cnt = 0;
+            root = trim(root, nullptr, &lo, last.pos == nullptr ? nullptr : &last.pos->key(), cnt);
+            fix_ends();
+            len -= cnt;
+            return last;
+        }
+        /**
+         * remove every element satisfying pred, then rebuild the survivors into a balanced tree, all in O(n)
+         */
+        template<class Pred>
+        size_t erase_if(Pred pred) {
+            node *vine = nullptr, **tail = &vine, *rest = root;
+            int cnt = 0;
+            while (rest != nullptr) {
+                if (rest->left != nullptr) {
+                    node *tmp = rest->left;
+                    rest->left = tmp->right;
+                    tmp->right = rest;
+                    rest = tmp;
+                }
+                else if (pred(rest->data)) {
+                    node *tmp = rest;
+                    rest = rest->right;
+                    drop(tmp);
+                    ++cnt;
+                }
+                else {
+                    *tail = rest;
+                    tail = &rest->right;
+                    rest = rest->right;
+                }
+            }
+            *tail = nullptr;
+            len -= cnt;
+            root = build(vine, len, nullptr);
+            fix_ends();
+            return cnt;
+        }
         size_t count(const Key &key) const {
             node *tmp = search(key);
             if (tmp == nullptr) return 0;
             else return 1;
         }
         iterator find(const Key &key) {
-            node *tmp = search(key);
+            node *tmp = access(search(key));
             if (tmp == nullptr) return iterator(nullptr, this);
             else return iterator(tmp, this);
         }
@@ -389,8 +657,26 @@ namespace sjtu {
             if (tmp == nullptr) return const_iterator(nullptr, this);
             else return const_iterator(tmp, this);
         }
+        /**
+         * cut [first, last) into k consecutive pieces whose sizes differ by at most one and write the k + 1
+         * boundaries to bounds, using subtree sizes: O(k log n) on a balanced tree
+         */
+        void split(const_iterator first, const_iterator last, int k, const_iterator *bounds) const {
+            if (first.it != this || last.it != this || k <= 0) throw invalid_iterator();
+            int lo = rank(first.pos), hi = rank(last.pos);
+            if (hi < lo) throw invalid_iterator();
+            for (int i = 0; i <= k; ++i) bounds[i] = const_iterator(select(lo + (int) ((long long) (hi - lo) * i / k)), this);
+        }
+        void split(int k, const_iterator *bounds) const {
+            split(cbegin(), cend(), k, bounds);
+        }
     };
 
+    template<class Key, class T, class Compare, bool Splay, bool Separate>
+    void swap(map<Key, T, Compare, Splay, Separate> &a, map<Key, T, Compare, Splay, Separate> &b) noexcept {
+        a.swap(b);
+    }
+
 }
 
 #endif
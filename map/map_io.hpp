@@ -0,0 +1,80 @@
+/**
+ * implement saving sjtu::map to a file descriptor and loading it back; kept apart from map1.hpp
+ * because it needs POSIX i/o, so only the code that stores maps has to include it
+ */
+#ifndef SJTU_MAP_IO_HPP
+#define SJTU_MAP_IO_HPP
+
+#include <climits>
+#include <cstdint>
+#include "map1.hpp"
+#include "serializer.hpp"
+
+namespace sjtu {
+
+    const uint64_t MAP_FILE_MAGIC = 0x3150414d55544a53ULL;
+
+    /**
+     * write the elements of m in key order to fd: a header with the element count, then every pair
+     * through serializer<Key> and serializer<T>
+     */
+    template<class Key, class T, class Compare, bool Splay, bool Separate>
+    void save(const map<Key, T, Compare, Splay, Separate> &m, int fd) {
+        typedef typename map<Key, T, Compare, Splay, Separate>::const_iterator const_iterator;
+        fd_writer out(fd);
+        uint64_t head[4] = {MAP_FILE_MAGIC, serializer<Key>::fixed, serializer<T>::fixed, (uint64_t) m.size()};
+        out.put(head, sizeof(head));
+        for (const_iterator i = m.cbegin(); i != m.cend(); ++i) {
+            serializer<Key>::save(out, i->first);
+            serializer<T>::save(out, i->second);
+        }
+        out.flush();
+    }
+
+    /**
+     * replace the contents of m with what save wrote to fd; the nodes arrive sorted and are built into
+     * a balanced tree in O(n) without any comparisons beyond checking the order.
+     * Key and T must be default constructible. Throws runtime_error on a bad or truncated file,
+     * leaving the map empty. On success fd is left just past the map, so more data can follow it.
+     */
+    template<class Key, class T, class Compare, bool Splay, bool Separate>
+    void load(map<Key, T, Compare, Splay, Separate> &m, int fd) {
+        typedef typename map<Key, T, Compare, Splay, Separate>::node node;
+        m.clear();
+        fd_reader in(fd);
+        uint64_t head[4];
+        in.get(head, sizeof(head));
+        if (head[0] != MAP_FILE_MAGIC || head[1] != serializer<Key>::fixed || head[2] != serializer<T>::fixed
+            || head[3] > INT_MAX) throw runtime_error();
+        node *vine = nullptr, **tail = &vine, *last = nullptr;
+        uint64_t n = 0;
+        try {
+            for (; n < head[3]; ++n) {
+                Key k;
+                T t;
+                serializer<Key>::load(in, k);
+                serializer<T>::load(in, t);
+                if (last != nullptr && !m.com(last->key(), k)) throw runtime_error();
+                last = *tail = new node(k, t, nullptr, m.pool);
+                tail = &last->right;
+            }
+        }
+        catch (...) {
+            *tail = nullptr;
+            while (vine != nullptr) {
+                node *tmp = vine;
+                vine = vine->right;
+                m.drop(tmp);
+            }
+            throw;
+        }
+        *tail = nullptr;
+        in.give_back();
+        m.len = n;
+        m.root = m.build(vine, m.len, nullptr);
+        m.fix_ends();
+    }
+
+}
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * implement running a function over a map on several threads; kept apart from map1.hpp because it
+ * needs the thread library, so only the code that walks maps in parallel has to include it
+ */
+#ifndef SJTU_MAP_PARALLEL_HPP
+#define SJTU_MAP_PARALLEL_HPP
+
+#include <thread>
+#include <vector>
+#include <exception>
+#include "map1.hpp"
+
+namespace sjtu {
+
+    /**
+     * joins every thread that was started when it goes out of scope, so a failure to start
+     * the rest of them does not leave any running
+     */
+    struct thread_joiner {
+        std::vector<std::thread> &worker;
+        ~thread_joiner() {
+            for (size_t i = 0; i < worker.size(); ++i)
+                if (worker[i].joinable()) worker[i].join();
+        }
+    };
+
+    /**
+     * call f on every element of [first, last) of m, cut by m.split into one piece per thread (by default
+     * one per core). f runs concurrently and must be safe to call so; it may modify the values but not
+     * the map. The first exception thrown by f is rethrown once every thread has finished.
+     * Works for any map with split(), such as map and bloom_map.
+     */
+    template<class Map, class F>
+    void parallel_for_each(Map &m, typename Map::iterator first, typename Map::iterator last, F f, int threads = 0) {
+        typedef typename Map::const_iterator const_iterator;
+        if (threads <= 0) threads = std::thread::hardware_concurrency();
+        if (threads <= 0) threads = 1;
+        std::vector<const_iterator> bounds(threads + 1);
+        m.split(first, last, threads, bounds.data());
+        std::vector<std::exception_ptr> err(threads);
+        std::vector<std::thread> worker;
+        worker.reserve(threads - 1);
+        auto run = [&](int i) {
+            try {
+                for (const_iterator p = bounds[i]; p != bounds[i + 1]; ++p) f(*p);
+            }
+            catch (...) {
+                err[i] = std::current_exception();
+            }
+        };
+        {
+            thread_joiner joiner = {worker};
+            for (int i = 1; i < threads; ++i) worker.push_back(std::thread(run, i));
+            run(0);
+        }
+        for (int i = 0; i < threads; ++i)
+            if (err[i]) std::rethrow_exception(err[i]);
+    }
+
+    template<class Map, class F>
+    void parallel_for_each(Map &m, F f, int threads = 0) {
+        parallel_for_each(m, m.begin(), m.end(), f, threads);
+    }
+
+}
+
+#endif
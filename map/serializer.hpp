@@ -0,0 +1,157 @@
+/**
+ * implement buffered binary i/o on a file descriptor, and the per-type hooks containers serialize through
+ */
+#ifndef SJTU_SERIALIZER_HPP
+#define SJTU_SERIALIZER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include <type_traits>
+#include <unistd.h>
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+    class fd_writer {
+    public:
+        static const size_t BUFFER_SIZE = 1 << 20;
+        int fd;
+        char *buf;
+        size_t used;
+
+        explicit fd_writer(int f): fd(f), buf(new char[BUFFER_SIZE]), used(0) {}
+        fd_writer(const fd_writer &) = delete;
+        fd_writer & operator=(const fd_writer &) = delete;
+        ~fd_writer() {
+            delete [] buf;
+        }
+        void drain(const char *p, size_t n) {
+            while (n > 0) {
+                ssize_t k = ::write(fd, p, n);
+                if (k < 0 && errno == EINTR) continue;
+                if (k <= 0) throw runtime_error();
+                p += k;
+                n -= k;
+            }
+        }
+        void put(const void *p, size_t n) {
+            if (used + n > BUFFER_SIZE) {
+                drain(buf, used);
+                used = 0;
+                if (n > BUFFER_SIZE) {
+                    drain((const char*) p, n);
+                    return;
+                }
+            }
+            memcpy(buf + used, p, n);
+            used += n;
+        }
+        void flush() {
+            drain(buf, used);
+            used = 0;
+        }
+    };
+
+    /**
+     * reads ahead on a seekable fd and gives the unused bytes back with give_back(); on a pipe or
+     * socket, where they could not be given back, it reads exactly what is asked for
+     */
+    class fd_reader {
+    public:
+        static const size_t BUFFER_SIZE = 1 << 20;
+        int fd;
+        char *buf;
+        size_t begin, end;
+        bool seekable;
+
+        explicit fd_reader(int f): fd(f), buf(new char[BUFFER_SIZE]), begin(0), end(0),
+                                   seekable(lseek(f, 0, SEEK_CUR) >= 0) {}
+        fd_reader(const fd_reader &) = delete;
+        fd_reader & operator=(const fd_reader &) = delete;
+        ~fd_reader() {
+            delete [] buf;
+        }
+        /**
+         * throws runtime_error if the stream ends first
+         */
+        void get(void *p, size_t n) {
+            char *out = (char*) p;
+            while (n > 0) {
+                if (begin == end) {
+                    ssize_t k = ::read(fd, buf, seekable || n > BUFFER_SIZE ? BUFFER_SIZE : n);
+                    if (k < 0 && errno == EINTR) continue;
+                    if (k <= 0) throw runtime_error();
+                    begin = 0;
+                    end = k;
+                }
+                size_t k = end - begin < n ? end - begin : n;
+                memcpy(out, buf + begin, k);
+                begin += k;
+                out += k;
+                n -= k;
+            }
+        }
+        /**
+         * move the file offset back over the bytes read ahead but not used, so whatever follows
+         * can be read by the next reader
+         */
+        void give_back() {
+            if (begin == end) return;
+            if (lseek(fd, -(off_t) (end - begin), SEEK_CUR) < 0) throw runtime_error();
+            begin = end;
+        }
+    };
+
+    /**
+     * Specialize serializer for a type to make it storable: save writes it, load overwrites a default
+     * constructed object with it, and fixed is its record size, or 0 if the size varies.
+     * Trivially copyable types are written as their bytes, so files are only portable between
+     * builds with the same layout and endianness.
+     */
+    template<class U, class Enable = void>
+    struct serializer;
+
+    template<class U>
+    struct serializer<U, typename std::enable_if<std::is_trivially_copyable<U>::value>::type> {
+        static const size_t fixed = sizeof(U);
+        static void save(fd_writer &out, const U &x) {
+            out.put(&x, sizeof(U));
+        }
+        static void load(fd_reader &in, U &x) {
+            in.get(&x, sizeof(U));
+        }
+    };
+
+    template<>
+    struct serializer<std::string> {
+        static const size_t fixed = 0;
+        static void save(fd_writer &out, const std::string &x) {
+            uint64_t n = x.size();
+            out.put(&n, sizeof(n));
+            out.put(x.data(), n);
+        }
+        /**
+         * the length comes from the file, so the string grows a chunk at a time as the bytes arrive:
+         * a corrupt length runs into the end of the input and throws before it can allocate much
+         */
+        static void load(fd_reader &in, std::string &x) {
+            static const uint64_t CHUNK = 1 << 16;
+            uint64_t n;
+            in.get(&n, sizeof(n));
+            if (n > x.max_size()) throw runtime_error();
+            x.clear();
+            for (uint64_t done = 0; done < n; ) {
+                size_t k = n - done < CHUNK ? n - done : CHUNK;
+                x.resize(done + k);
+                in.get(&x[done], k);
+                done += k;
+            }
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ * implement a pool that keeps objects in place until they are destroyed
+ */
+#ifndef SJTU_VALUE_ARENA_HPP
+#define SJTU_VALUE_ARENA_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace sjtu {
+
+    /**
+     * Objects live in chunks of about 4KB that are only returned when the arena dies, and freed slots are
+     * reused through a free list, so making or destroying an object is O(1) and an object never moves.
+     * Copying an arena gives an empty one: its objects belong to whoever made them.
+     */
+    template<class V>
+    class value_arena {
+    public:
+        union slot {
+            slot *next;
+            typename std::aligned_storage<sizeof(V), alignof(V)>::type raw;
+        };
+        static const int CHUNK = 4096 / sizeof(slot) > 8 ? 4096 / sizeof(slot) : 8;
+        struct chunk {
+            chunk *next;
+            slot s[CHUNK];
+        };
+        chunk *chunks;
+        slot *free_list;
+
+        value_arena(): chunks(nullptr), free_list(nullptr) {}
+        value_arena(const value_arena &): chunks(nullptr), free_list(nullptr) {}
+        value_arena & operator=(const value_arena &) {
+            return *this;
+        }
+        /**
+         * exchange every chunk, and so every live object, with other
+         */
+        void swap(value_arena &other) noexcept {
+            chunk *c = chunks;
+            chunks = other.chunks;
+            other.chunks = c;
+            slot *f = free_list;
+            free_list = other.free_list;
+            other.free_list = f;
+        }
+        /**
+         * every object must have been destroyed already
+         */
+        ~value_arena() {
+            while (chunks != nullptr) {
+                chunk *tmp = chunks;
+                chunks = chunks->next;
+                delete tmp;
+            }
+        }
+        void grow() {
+            chunk *c = new chunk;
+            c->next = chunks;
+            chunks = c;
+            for (int i = 0; i < CHUNK; ++i) {
+                c->s[i].next = free_list;
+                free_list = &c->s[i];
+            }
+        }
+        V *make(const V &v) {
+            if (free_list == nullptr) grow();
+            slot *s = free_list;
+            free_list = s->next;
+            try {
+                return new (&s->raw) V(v);
+            }
+            catch (...) {
+                s->next = free_list;
+                free_list = s;
+                throw;
+            }
+        }
+        void destroy(V *p) {
+            p->~V();
+            slot *s = (slot*) p;
+            s->next = free_list;
+            free_list = s;
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,382 @@
+/**
+ * implement a multi-version map whose snapshots stay readable while writers go on
+ */
+#ifndef SJTU_VERSIONED_MAP_HPP
+#define SJTU_VERSIONED_MAP_HPP
+
+#include <functional>
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+    /**
+     * A persistent treap: nodes are never modified once published, and a write copies only the
+     * O(log n) nodes on its search path, sharing the rest with every older version.
+     * Nodes are reference counted by their parents and by open snapshots, so a version is freed as soon
+     * as the map has moved past it and the last snapshot of it is gone.
+     * Writers are serialized by a mutex, which a snapshot also takes just long enough to pin the root;
+     * after that, reading a snapshot needs no locking at all.
+     */
+    template<
+            class Key,
+            class T,
+            class Compare = std::less<Key>
+    > class versioned_map {
+    public:
+        typedef pair<const Key, T> value_type;
+        struct node {
+            value_type data;
+            node *left, *right;
+            unsigned int pri;
+            std::atomic<int> ref;
+            /**
+             * takes over the references held by l and r
+             */
+            node(const value_type &v, node *l, node *r, unsigned int p): data(v), left(l), right(r), pri(p), ref(1) {}
+        };
+
+        static node *retain(node *p) {
+            if (p != nullptr) p->ref.fetch_add(1, std::memory_order_relaxed);
+            return p;
+        }
+        static void release(node *p) {
+            while (p != nullptr && p->ref.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                release(p->left);
+                node *r = p->right;
+                delete p;
+                p = r;
+            }
+        }
+        static node *search(node *t, const Key &k, const Compare &com) {
+            while (t != nullptr) {
+                if (com(k, t->data.first)) t = t->left;
+                else if (com(t->data.first, k)) t = t->right;
+                else return t;
+            }
+            return nullptr;
+        }
+
+        class snapshot;
+        class const_iterator {
+        public:
+            node *pos;
+            const snapshot *it;
+
+            const_iterator() {
+                pos = nullptr;
+                it = nullptr;
+            }
+            const_iterator(node *obj1, const snapshot *obj2) {
+                pos = obj1;
+                it = obj2;
+            }
+            /**
+             * nodes are shared between versions and have no parent links, so a step searches
+             * the snapshot's root for the neighbour: O(log n) per step
+             */
+            const_iterator & operator++() {
+                if (pos == nullptr) throw invalid_iterator();
+                node *t = it->root, *ret = nullptr;
+                while (t != nullptr) {
+                    if (it->com(pos->data.first, t->data.first)) ret = t, t = t->left;
+                    else t = t->right;
+                }
+                pos = ret;
+                return *this;
+            }
+            const_iterator operator++(int) {
+                const_iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+            const_iterator & operator--() {
+                node *t = it->root, *ret = nullptr;
+                while (t != nullptr) {
+                    if (pos == nullptr || it->com(t->data.first, pos->data.first)) ret = t, t = t->right;
+                    else t = t->left;
+                }
+                if (ret == nullptr) throw invalid_iterator();
+                pos = ret;
+                return *this;
+            }
+            const_iterator operator--(int) {
+                const_iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+            const value_type & operator*() const {
+                if (pos == nullptr) throw invalid_iterator();
+                return pos->data;
+            }
+            const value_type* operator->() const noexcept {
+                return &pos->data;
+            }
+            bool operator==(const const_iterator &rhs) const {
+                return pos == rhs.pos && it == rhs.it;
+            }
+            bool operator!=(const const_iterator &rhs) const {
+                return pos != rhs.pos || it != rhs.it;
+            }
+        };
+        typedef const_iterator iterator;
+
+        /**
+         * a frozen view of one version; copying a snapshot is O(1)
+         */
+        class snapshot {
+        public:
+            node *root;
+            size_t len;
+            unsigned long long ver;
+            Compare com;
+
+            snapshot(): root(nullptr), len(0), ver(0) {}
+            snapshot(node *r, size_t n, unsigned long long v, const Compare &c): root(r), len(n), ver(v), com(c) {}
+            snapshot(const snapshot &other): root(retain(other.root)), len(other.len), ver(other.ver), com(other.com) {}
+            snapshot(snapshot &&other) noexcept: root(other.root), len(other.len), ver(other.ver), com(other.com) {
+                other.root = nullptr;
+                other.len = 0;
+            }
+            snapshot & operator=(const snapshot &other) {
+                if (this == &other) return *this;
+                node *old = root;
+                root = retain(other.root);
+                len = other.len;
+                ver = other.ver;
+                com = other.com;
+                release(old);
+                return *this;
+            }
+            ~snapshot() {
+                release(root);
+            }
+            const T & at(const Key &key) const {
+                node *p = search(root, key, com);
+                if (p == nullptr) throw index_out_of_bound();
+                return p->data.second;
+            }
+            const T & operator[](const Key &key) const {
+                return at(key);
+            }
+            size_t count(const Key &key) const {
+                return search(root, key, com) != nullptr;
+            }
+            const_iterator find(const Key &key) const {
+                return const_iterator(search(root, key, com), this);
+            }
+            const_iterator begin() const {
+                node *t = root;
+                if (t != nullptr) while (t->left != nullptr) t = t->left;
+                return const_iterator(t, this);
+            }
+            const_iterator cbegin() const {
+                return begin();
+            }
+            const_iterator end() const {
+                return const_iterator(nullptr, this);
+            }
+            const_iterator cend() const {
+                return end();
+            }
+            bool empty() const {
+                return len == 0;
+            }
+            size_t size() const {
+                return len;
+            }
+            unsigned long long version() const {
+                return ver;
+            }
+        };
+
+        node *root;
+        size_t len;
+        unsigned long long ver;
+        unsigned int seed;
+        Compare com;
+        mutable std::mutex lock;
+
+        unsigned int rand() {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            return seed;
+        }
+        /**
+         * the helpers below only borrow their node arguments and return a fresh reference
+         */
+        void split(node *t, const Key &k, node *&a, node *&b) {
+            if (t == nullptr) {
+                a = b = nullptr;
+                return;
+            }
+            node *x, *y;
+            if (com(t->data.first, k)) {
+                split(t->right, k, x, y);
+                a = new node(t->data, retain(t->left), x, t->pri);
+                b = y;
+            }
+            else {
+                split(t->left, k, x, y);
+                a = x;
+                b = new node(t->data, y, retain(t->right), t->pri);
+            }
+        }
+        node *merge(node *a, node *b) {
+            if (a == nullptr) return retain(b);
+            if (b == nullptr) return retain(a);
+            if (a->pri > b->pri) return new node(a->data, retain(a->left), merge(a->right, b), a->pri);
+            return new node(b->data, merge(a, b->left), retain(b->right), b->pri);
+        }
+        node *insert(node *t, const value_type &v, unsigned int p) {
+            if (t == nullptr || p > t->pri) {
+                node *a, *b;
+                split(t, v.first, a, b);
+                return new node(v, a, b, p);
+            }
+            if (com(v.first, t->data.first)) return new node(t->data, insert(t->left, v, p), retain(t->right), t->pri);
+            return new node(t->data, retain(t->left), insert(t->right, v, p), t->pri);
+        }
+        node *replace(node *t, const value_type &v) {
+            if (com(v.first, t->data.first)) return new node(t->data, replace(t->left, v), retain(t->right), t->pri);
+            if (com(t->data.first, v.first)) return new node(t->data, retain(t->left), replace(t->right, v), t->pri);
+            return new node(v, retain(t->left), retain(t->right), t->pri);
+        }
+        node *remove(node *t, const Key &k) {
+            if (com(k, t->data.first)) return new node(t->data, remove(t->left, k), retain(t->right), t->pri);
+            if (com(t->data.first, k)) return new node(t->data, retain(t->left), remove(t->right, k), t->pri);
+            return merge(t->left, t->right);
+        }
+        void publish(node *r) {
+            node *old = root;
+            root = r;
+            ++ver;
+            release(old);
+        }
+
+        versioned_map(): root(nullptr), len(0), ver(0), seed(2463534242u) {}
+        versioned_map(const versioned_map &other) {
+            std::lock_guard<std::mutex> guard(other.lock);
+            root = retain(other.root);
+            len = other.len;
+            ver = other.ver;
+            seed = other.seed;
+            com = other.com;
+        }
+        versioned_map & operator=(const versioned_map &other) {
+            if (this == &other) return *this;
+            snapshot s = other.snap();
+            std::lock_guard<std::mutex> guard(lock);
+            len = s.len;
+            publish(retain(s.root));
+            return *this;
+        }
+        /**
+         * takes other's current version without touching any reference count; other becomes empty at a
+         * new version, and snapshots already taken of it are unaffected
+         */
+        versioned_map(versioned_map &&other) {
+            std::lock_guard<std::mutex> guard(other.lock);
+            root = other.root;
+            len = other.len;
+            ver = other.ver;
+            seed = other.seed;
+            com = other.com;
+            other.root = nullptr;
+            other.len = 0;
+            ++other.ver;
+        }
+        versioned_map & operator=(versioned_map &&other) {
+            if (this == &other) return *this;
+            swap(other);
+            std::lock_guard<std::mutex> guard(other.lock);
+            other.len = 0;
+            other.publish(nullptr);
+            return *this;
+        }
+        /**
+         * exchange the current versions; each map moves on to a new version number
+         */
+        void swap(versioned_map &other) {
+            if (this == &other) return;
+            std::lock(lock, other.lock);
+            std::lock_guard<std::mutex> a(lock, std::adopt_lock), b(other.lock, std::adopt_lock);
+            std::swap(root, other.root);
+            std::swap(len, other.len);
+            std::swap(com, other.com);
+            ++ver;
+            ++other.ver;
+        }
+        ~versioned_map() {
+            release(root);
+        }
+        /**
+         * pin the current version; writes made afterwards are invisible to it
+         */
+        snapshot snap() const {
+            std::lock_guard<std::mutex> guard(lock);
+            return snapshot(retain(root), len, ver, com);
+        }
+        /**
+         * insert value if its key is absent; returns whether it was inserted
+         */
+        bool insert(const value_type &value) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (search(root, value.first, com) != nullptr) return false;
+            publish(insert(root, value, rand()));
+            ++len;
+            return true;
+        }
+        /**
+         * map key to value, inserting it if needed; stands in for a writable operator[],
+         * since a reference into a published node would let writers modify old versions
+         */
+        void assign(const Key &key, const T &value) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (search(root, key, com) != nullptr) publish(replace(root, value_type(key, value)));
+            else {
+                publish(insert(root, value_type(key, value), rand()));
+                ++len;
+            }
+        }
+        size_t erase(const Key &key) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (search(root, key, com) == nullptr) return 0;
+            publish(remove(root, key));
+            --len;
+            return 1;
+        }
+        void clear() {
+            std::lock_guard<std::mutex> guard(lock);
+            publish(nullptr);
+            len = 0;
+        }
+        size_t count(const Key &key) const {
+            std::lock_guard<std::mutex> guard(lock);
+            return search(root, key, com) != nullptr;
+        }
+        bool empty() const {
+            return size() == 0;
+        }
+        size_t size() const {
+            std::lock_guard<std::mutex> guard(lock);
+            return len;
+        }
+        unsigned long long version() const {
+            std::lock_guard<std::mutex> guard(lock);
+            return ver;
+        }
+    };
+
+    template<class Key, class T, class Compare>
+    void swap(versioned_map<Key, T, Compare> &a, versioned_map<Key, T, Compare> &b) {
+        a.swap(b);
+    }
+
+}
+
+#endif
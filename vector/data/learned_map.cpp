@@ -0,0 +1,85 @@
+#include "learned_map.hpp"
+#include "../../map/map1.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+
+unsigned long long seed = 88172645463325252ULL;
+unsigned long long next() {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+template<typename Key>
+bool check(const sjtu::vector<Key> &keys) { //lower_bound agrees with binary search for hits, misses and both ends
+	sjtu::vector<int> values;
+	for (int i = 0; i < (int) keys.size(); ++i) values.push_back(i);
+	sjtu::learned_map<Key, int> m(keys, values);
+	const Key *b = keys.data, *e = keys.data + keys.size();
+	for (int i = 0; i < 200000; ++i) {
+		Key k = i % 2 ? keys[next() % keys.size()] : (Key) next();
+		if (i % 7 == 0) k += (Key) (next() % 3) - 1;
+		if (m.lower_bound(k) != std::lower_bound(b, e, k) - b) return false;
+		int p = m.find(k);
+		if ((p != (int) m.size()) != std::binary_search(b, e, k)) return false;
+		if (p != (int) m.size() && m.value(p) != std::lower_bound(b, e, k) - b) return false;
+	}
+	return m.lower_bound(keys[0]) == 0 && m.find(keys[keys.size() - 1]) == (int) keys.size() - 1;
+}
+
+bool check1() { //dense ids, ids with gaps, duplicates, clustered negative keys, 64-bit spread
+	sjtu::vector<int> a, b, c;
+	sjtu::vector<long long> d;
+	sjtu::vector<unsigned long long> e;
+	for (int i = 0; i < 100000; ++i) a.push_back(i + 1000);
+	int x = 0;
+	for (int i = 0; i < 100000; ++i) b.push_back(x += next() % 100 + 1);
+	for (int i = 0; i < 100000; ++i) c.push_back(i / 3);
+	long long y = -5000000000LL;
+	for (int i = 0; i < 100000; ++i) d.push_back(y += (i / 1000 % 2 ? 1 : 100000));
+	std::vector<unsigned long long> tmp;
+	for (int i = 0; i < 100000; ++i) tmp.push_back(next());
+	std::sort(tmp.begin(), tmp.end());
+	for (int i = 0; i < 100000; ++i) e.push_back(tmp[i]);
+	return check(a) && check(b) && check(c) && check(d) && check(e);
+}
+
+bool check2() { //lookups against binary search and sjtu::map
+	const int n = 2000000, q = 5000000;
+	sjtu::vector<long long> keys;
+	sjtu::vector<int> values;
+	long long x = 0;
+	for (int i = 0; i < n; ++i) {
+		keys.push_back(x += next() % 64 + 1);
+		values.push_back(i);
+	}
+	sjtu::learned_map<long long, int> m(keys, values);
+	sjtu::map<long long, int> t;
+	for (int i = 0; i < n; ++i) t[keys[next() % n]] = i;
+	long long *probe = new long long[q];
+	for (int i = 0; i < q; ++i) probe[i] = next() % (x + 1);
+	long long s1 = 0, s2 = 0, s3 = 0;
+	clock_t t0 = clock();
+	for (int i = 0; i < q; ++i) s1 += m.lower_bound(probe[i]);
+	clock_t t1 = clock();
+	for (int i = 0; i < q; ++i) s2 += std::lower_bound(keys.data, keys.data + n, probe[i]) - keys.data;
+	clock_t t2 = clock();
+	for (int i = 0; i < q; ++i) s3 += t.count(probe[i]);
+	clock_t t3 = clock();
+	printf("%d keys, %d segments; %d lookups: learned %.3fs, binary search %.3fs, sjtu::map %.3fs (%lld) ", n, (int) m.segments(), q,
+		(double) (t1 - t0) / CLOCKS_PER_SEC, (double) (t2 - t1) / CLOCKS_PER_SEC, (double) (t3 - t2) / CLOCKS_PER_SEC, s3);
+	delete [] probe;
+	return s1 == s2;
+}
+
+int main() {
+	if (!check1()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,95 @@
+#include "vector.hpp"
+#include "../../deque/deque1.hpp"
+#include "../../map/map1.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <utility>
+#include <cstdio>
+
+int copies = 0, alive = 0;
+
+struct Counted { //counts copies and live objects
+	int x;
+	Counted(int v = 0): x(v) { ++alive; }
+	Counted(const Counted &other): x(other.x) { ++copies; ++alive; }
+	Counted(Counted &&other) noexcept: x(other.x) { ++alive; }
+	Counted &operator=(const Counted &other) { x = other.x; ++copies; return *this; }
+	Counted &operator=(Counted &&other) noexcept { x = other.x; return *this; }
+	~Counted() { --alive; }
+};
+
+sjtu::vector<Counted> make(int n) {
+	sjtu::vector<Counted> v;
+	for (int i = 0; i < n; ++i) v.push_back(Counted(i));
+	return v;
+}
+
+bool check1() { //growth, returns and moves never copy an element, and every element is destroyed exactly once
+	{
+		copies = 0;
+		sjtu::vector<Counted> v = make(100000);
+		int after_growth = copies;
+		sjtu::vector<Counted> w(std::move(v));
+		sjtu::vector<Counted> u;
+		u = std::move(w);
+		swap(u, v);
+		if (copies != after_growth || v.size() != 100000 || !u.empty() || !w.empty()) return false;
+		for (int i = 0; i < 100000; ++i) if (v[i].x != i) return false;
+		u.push_back(Counted(7));
+		v.pop_back();
+		v.erase(0);
+		v.insert(v.begin() + 5, Counted(-1));
+		if (u.size() != 1 || v.size() != 99999 || v[5].x != -1 || v[6].x != 6 || v.back().x != 99998) return false;
+		printf("copies: %d ", copies);
+	}
+	return alive == 0;
+}
+
+bool check2() { //vectors of deques and maps move their elements when they grow
+	sjtu::vector<sjtu::deque<int> > vd;
+	sjtu::vector<sjtu::map<int, std::string> > vm;
+	for (int i = 0; i < 1000; ++i) {
+		sjtu::deque<int> d;
+		sjtu::map<int, std::string> m;
+		for (int j = 0; j < 100; ++j) d.push_back(i * 100 + j), m[j] = std::to_string(i + j);
+		vd.push_back(std::move(d));
+		vm.push_back(std::move(m));
+		if (!d.empty() || m.size() != 0) return false;
+	}
+	for (int i = 0; i < 1000; i += 7) {
+		if (vd[i].size() != 100 || vd[i][99] != i * 100 + 99) return false;
+		if (vm[i].size() != 100 || vm[i].at(42) != std::to_string(i + 42)) return false;
+	}
+	sjtu::vector<sjtu::deque<int> > copy(vd);
+	vd.clear();
+	return copy.size() == 1000 && copy[999].back() == 99999;
+}
+
+bool check3() { //inserting or pushing a copy of the vector's own element, with and without growing
+	sjtu::vector<std::string> v;
+	std::vector<std::string> ref;
+	for (int i = 0; i < 10; ++i) v.push_back("s" + std::to_string(i)), ref.push_back("s" + std::to_string(i));
+	v.insert(v.begin() + 3, v[5]); //10 elements fill the first allocation, so this one grows too
+	ref.insert(ref.begin() + 3, std::string(ref[5]));
+	if (v[3] != "s5" || v[4] != "s3") return false;
+	srand(48);
+	for (int i = 0; i < 2000; ++i) {
+		int k = rand() % (ref.size() + 1), j = rand() % ref.size();
+		if (i % 3) v.insert(v.begin() + k, v[j]), ref.insert(ref.begin() + k, std::string(ref[j]));
+		else v.insert(k, v[j]), ref.insert(ref.begin() + k, std::string(ref[j]));
+		if (i % 5 == 0) v.push_back(v[j]), ref.push_back(std::string(ref[j]));
+	}
+	if (v.size() != ref.size()) return false;
+	for (int i = 0; i < (int) ref.size(); ++i) if (v[i] != ref[i]) return false;
+	return true;
+}
+
+int main() {
+	if (!check1()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check3()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	return 0;
+}
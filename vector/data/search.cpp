@@ -0,0 +1,107 @@
+#include "search.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+
+unsigned long long seed = 88172645463325252ULL;
+unsigned long long next() {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+template<typename T>
+bool check_type(T scale) { //every size up to 300 and a large one, with duplicates, against the standard searches
+	for (int t = 0; t <= 301; ++t) {
+		int n = t == 301 ? 100000 : t;
+		sjtu::vector<T> v;
+		T x = 0;
+		for (int i = 0; i < n; ++i) v.push_back(x += (T) (next() % 3) * scale);
+		const T *b = v.data, *e = v.data + n;
+		T probe[64];
+		size_t lo[64], hi[64];
+		for (int i = 0; i < 64; ++i) probe[i] = (T) (next() % (n * 3 + 5)) * scale - 2 * scale;
+		sjtu::lower_bound(v, probe, 64, lo);
+		sjtu::upper_bound(v, probe, 64, hi);
+		for (int i = 0; i < 64; ++i) {
+			if (sjtu::lower_bound(v, probe[i]) != (size_t) (std::lower_bound(b, e, probe[i]) - b)) return false;
+			if (sjtu::upper_bound(v, probe[i]) != (size_t) (std::upper_bound(b, e, probe[i]) - b)) return false;
+			if (sjtu::contains(v, probe[i]) != std::binary_search(b, e, probe[i])) return false;
+			if (lo[i] != sjtu::lower_bound(v, probe[i]) || hi[i] != sjtu::upper_bound(v, probe[i])) return false;
+		}
+	}
+	return true;
+}
+
+bool check1() {
+	return check_type<int>(1) && check_type<long long>(1000000000000LL) && check_type<double>(0.5)
+		&& check_type<float>(0.25f) && check_type<unsigned>(7) && check_type<short>(1);
+}
+
+template<typename T>
+bool check_kernels() { //each instruction set agrees with the scalar count, whatever the cpu would pick
+	T w[16];
+	for (int t = 0; t < 10000; ++t) {
+		for (int i = 0; i < 16; ++i) w[i] = (T) (next() % 40) - 20;
+		std::sort(w, w + 16);
+		T key = (T) (next() % 44) - 22;
+		for (int upper = 0; upper < 2; ++upper) {
+			int expect = sjtu::search_count_scalar(w, key, upper);
+			if (__builtin_cpu_supports("sse4.2") && sjtu::search_count_sse(w, key, upper) != expect) return false;
+			if (__builtin_cpu_supports("avx2") && sjtu::search_count_avx2(w, key, upper) != expect) return false;
+		}
+	}
+	return true;
+}
+
+bool check2() {
+	return check_kernels<int32_t>() && check_kernels<int64_t>() && check_kernels<double>();
+}
+
+size_t branchy(const int *a, size_t n, int key) {
+	size_t l = 0, r = n;
+	while (l < r) {
+		size_t mid = (l + r) / 2;
+		if (a[mid] < key) l = mid + 1;
+		else r = mid;
+	}
+	return l;
+}
+
+bool check3() { //timings on a column too big for the cache
+	const int n = 16000000, q = 4000000;
+	sjtu::vector<int> v;
+	int x = 0;
+	for (int i = 0; i < n; ++i) v.push_back(x += next() % 100);
+	int *probe = new int[q];
+	size_t *out = new size_t[q];
+	for (int i = 0; i < q; ++i) probe[i] = next() % x;
+	long long s1 = 0, s2 = 0, s3 = 0, s4 = 0;
+	clock_t t0 = clock();
+	for (int i = 0; i < q; ++i) s1 += branchy(v.data, n, probe[i]);
+	clock_t t1 = clock();
+	for (int i = 0; i < q; ++i) s2 += std::lower_bound(v.data, v.data + n, probe[i]) - v.data;
+	clock_t t2 = clock();
+	for (int i = 0; i < q; ++i) s3 += sjtu::lower_bound(v, probe[i]);
+	clock_t t3 = clock();
+	sjtu::lower_bound(v, probe, q, out);
+	for (int i = 0; i < q; ++i) s4 += out[i];
+	clock_t t4 = clock();
+	printf("level %d; %d lookups in %d ints: hand-written %.3fs, std %.3fs, sjtu %.3fs, batched %.3fs ", sjtu::search_level(), q, n,
+		(double) (t1 - t0) / CLOCKS_PER_SEC, (double) (t2 - t1) / CLOCKS_PER_SEC,
+		(double) (t3 - t2) / CLOCKS_PER_SEC, (double) (t4 - t3) / CLOCKS_PER_SEC);
+	delete [] probe;
+	delete [] out;
+	return s1 == s2 && s2 == s3 && s3 == s4;
+}
+
+int main() {
+	if (!check1()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check3()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,179 @@
+#ifndef SJTU_LEARNED_MAP_HPP
+#define SJTU_LEARNED_MAP_HPP
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace sjtu {
+/**
+ * A read-only map over sorted integer keys that predicts where a key is instead of searching for it.
+ * Positions are modelled by a linear spline whose knots are chosen greedily so that no key is more
+ * than MaxError places from its prediction, and a radix table on the top bits of a key narrows down
+ * the spline segment to look at. A lookup is then a table read, a short search among a few knots and
+ * a binary search over at most 2 * MaxError + 2 keys.
+ * Positions double as iterators: find and lower_bound return an index, size() standing for end.
+ */
+template<typename Key, typename T, int MaxError = 32, int RadixBits = 18>
+class learned_map {
+	static_assert(std::is_integral<Key>::value, "learned_map needs integral keys");
+public:
+	struct knot {
+		uint64_t x;
+		double y;
+	};
+	vector<Key> keys;
+	vector<T> values;
+	vector<knot> knots;
+	vector<int> table;
+	Key lo, hi;
+	int shift;
+
+	uint64_t offset(const Key &k) const {
+		return (uint64_t) k - (uint64_t) lo;
+	}
+	static int width(uint64_t x) {
+		int ret = 0;
+		while (x > 0) {
+			++ret;
+			x >>= 1;
+		}
+		return ret;
+	}
+	/**
+	 * greedy spline corridor: extend the current segment while some line from its first knot stays
+	 * within MaxError of every point so far, and start a new one at the previous point otherwise
+	 */
+	void fit() {
+		int n = keys.size();
+		const Key *k = keys.data;
+		knot base = {0, 0}, prev = base;
+		double upper = 1e300, lower = -1e300;
+		knots.push_back(base);
+		for (int i = 1; i < n; ++i) {
+			if (k[i] == k[i - 1]) continue;
+			knot p = {offset(k[i]), (double) i};
+			double dx = (double) (p.x - base.x);
+			double slope = (p.y - base.y) / dx;
+			if (slope > upper || slope < lower) {
+				base = prev;
+				knots.push_back(base);
+				dx = (double) (p.x - base.x);
+				upper = (p.y + MaxError - base.y) / dx;
+				lower = (p.y - MaxError - base.y) / dx;
+			}
+			else {
+				double u = (p.y + MaxError - base.y) / dx, l = (p.y - MaxError - base.y) / dx;
+				if (u < upper) upper = u;
+				if (l > lower) lower = l;
+			}
+			prev = p;
+		}
+		if (prev.x != base.x) knots.push_back(prev);
+	}
+	void index() {
+		shift = width(offset(hi)) - RadixBits;
+		if (shift < 0) shift = 0;
+		int buckets = (int) (offset(hi) >> shift) + 1, m = knots.size(), j = 0;
+		for (int b = 0; b <= buckets; ++b) {
+			while (j < m && (int) (knots.data[j].x >> shift) < b) ++j;
+			table.push_back(j);
+		}
+	}
+	/**
+	 * the interpolated position of a key in [lo, hi]
+	 */
+	double predict(uint64_t x) const {
+		int b = (int) (x >> shift);
+		int l = table.data[b], r = table.data[b + 1];
+		while (l < r) {
+			int mid = (l + r) / 2;
+			if (knots.data[mid].x <= x) l = mid + 1;
+			else r = mid;
+		}
+		const knot &a = knots.data[l - 1];
+		if (l == (int) knots.size()) return a.y;
+		const knot &c = knots.data[l];
+		return a.y + (double) (x - a.x) * (c.y - a.y) / (double) (c.x - a.x);
+	}
+	static int search(const Key *k, int l, int r, const Key &key) {
+		while (l < r) {
+			int mid = (l + r) / 2;
+			if (k[mid] < key) l = mid + 1;
+			else r = mid;
+		}
+		return l;
+	}
+
+	/**
+	 * keys must be sorted in ascending order, values[i] belonging to keys[i]
+	 */
+	learned_map(const vector<Key> &k, const vector<T> &v) : keys(k), values(v) {
+		if (keys.size() != values.size()) throw runtime_error();
+		for (int i = 1; i < (int) keys.size(); ++i)
+			if (keys.data[i] < keys.data[i - 1]) throw runtime_error();
+		if (keys.empty()) return;
+		lo = keys.data[0];
+		hi = keys.data[keys.size() - 1];
+		fit();
+		index();
+	}
+	/**
+	 * the position of the first key not less than key
+	 */
+	int lower_bound(const Key &key) const {
+		int n = keys.size();
+		if (n == 0 || key <= lo) return 0;
+		if (key > hi) return n;
+		int p = (int) predict(offset(key));
+		int l = p - MaxError, r = p + MaxError + 2;
+		if (l < 0) l = 0;
+		if (r > n) r = n;
+		const Key *k = keys.data;
+		int ret = search(k, l, r, key);
+		// rounding can only ever push a prediction slightly past the bound; fall back if it did
+		if ((ret == l && l > 0 && !(k[l - 1] < key)) || (ret == r && r < n && k[r] < key)) ret = search(k, 0, n, key);
+		return ret;
+	}
+	/**
+	 * the position of key, or size() if it is absent
+	 */
+	int find(const Key &key) const {
+		int p = lower_bound(key);
+		if (p == (int) keys.size() || keys.data[p] != key) return keys.size();
+		return p;
+	}
+	size_t count(const Key &key) const {
+		return find(key) != (int) keys.size();
+	}
+	const T & at(const Key &key) const {
+		int p = find(key);
+		if (p == (int) keys.size()) throw index_out_of_bound();
+		return values.data[p];
+	}
+	const Key & key(int pos) const {
+		return keys[pos];
+	}
+	const T & value(int pos) const {
+		return values[pos];
+	}
+	bool empty() const {
+		return keys.empty();
+	}
+	size_t size() const {
+		return keys.size();
+	}
+	/**
+	 * the number of spline knots, a measure of how hard the key distribution is to model
+	 */
+	size_t segments() const {
+		return knots.size();
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,242 @@
+#ifndef SJTU_SEARCH_HPP
+#define SJTU_SEARCH_HPP
+
+#include "vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SJTU_SEARCH_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * Searches over sorted vectors of arithmetic values. The range is first halved without branches down to
+ * a window of 16 keys, and the window is then finished by counting the keys below the probe: with AVX2
+ * or SSE4.2 compares and a movemask when the running cpu has them and the type is int32, int64 or
+ * double, with a plain loop otherwise.
+ */
+namespace sjtu {
+
+/**
+ * 2 if the cpu has AVX2, 1 if it has SSE4.2, 0 otherwise; asked once
+ */
+inline int search_level() {
+#ifdef SJTU_SEARCH_X86
+	static const int level = __builtin_cpu_supports("avx2") ? 2 : (__builtin_cpu_supports("sse4.2") ? 1 : 0);
+	return level;
+#else
+	return 0;
+#endif
+}
+
+/**
+ * the number of p[0..16) below key, or with upper set, not above key
+ */
+template<typename T>
+inline int search_count_scalar(const T *p, const T &key, bool upper) {
+	int ret = 0;
+	if (upper) for (int i = 0; i < 16; ++i) ret += !(key < p[i]);
+	else for (int i = 0; i < 16; ++i) ret += p[i] < key;
+	return ret;
+}
+
+#ifdef SJTU_SEARCH_X86
+__attribute__((target("avx2"))) inline int search_count_avx2(const int32_t *p, int32_t key, bool upper) {
+	__m256i k = _mm256_set1_epi32(key);
+	__m256i a = _mm256_loadu_si256((const __m256i*) p), b = _mm256_loadu_si256((const __m256i*) (p + 8));
+	if (upper) {
+		int m = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, k)))
+			| _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(b, k))) << 8;
+		return 16 - __builtin_popcount(m);
+	}
+	int m = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(k, a)))
+		| _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(k, b))) << 8;
+	return __builtin_popcount(m);
+}
+__attribute__((target("sse4.2"))) inline int search_count_sse(const int32_t *p, int32_t key, bool upper) {
+	__m128i k = _mm_set1_epi32(key);
+	int m = 0;
+	for (int i = 0; i < 4; ++i) {
+		__m128i v = _mm_loadu_si128((const __m128i*) (p + 4 * i));
+		m |= _mm_movemask_ps(_mm_castsi128_ps(upper ? _mm_cmpgt_epi32(v, k) : _mm_cmpgt_epi32(k, v))) << (4 * i);
+	}
+	return upper ? 16 - __builtin_popcount(m) : __builtin_popcount(m);
+}
+__attribute__((target("avx2"))) inline int search_count_avx2(const int64_t *p, int64_t key, bool upper) {
+	__m256i k = _mm256_set1_epi64x(key);
+	int m = 0;
+	for (int i = 0; i < 4; ++i) {
+		__m256i v = _mm256_loadu_si256((const __m256i*) (p + 4 * i));
+		m |= _mm256_movemask_pd(_mm256_castsi256_pd(upper ? _mm256_cmpgt_epi64(v, k) : _mm256_cmpgt_epi64(k, v))) << (4 * i);
+	}
+	return upper ? 16 - __builtin_popcount(m) : __builtin_popcount(m);
+}
+__attribute__((target("sse4.2"))) inline int search_count_sse(const int64_t *p, int64_t key, bool upper) {
+	__m128i k = _mm_set1_epi64x(key);
+	int m = 0;
+	for (int i = 0; i < 8; ++i) {
+		__m128i v = _mm_loadu_si128((const __m128i*) (p + 2 * i));
+		m |= _mm_movemask_pd(_mm_castsi128_pd(upper ? _mm_cmpgt_epi64(v, k) : _mm_cmpgt_epi64(k, v))) << (2 * i);
+	}
+	return upper ? 16 - __builtin_popcount(m) : __builtin_popcount(m);
+}
+__attribute__((target("avx2"))) inline int search_count_avx2(const double *p, double key, bool upper) {
+	__m256d k = _mm256_set1_pd(key);
+	int m = 0;
+	for (int i = 0; i < 4; ++i) {
+		__m256d v = _mm256_loadu_pd(p + 4 * i);
+		m |= _mm256_movemask_pd(upper ? _mm256_cmp_pd(k, v, _CMP_LT_OQ) : _mm256_cmp_pd(v, k, _CMP_LT_OQ)) << (4 * i);
+	}
+	return upper ? 16 - __builtin_popcount(m) : __builtin_popcount(m);
+}
+__attribute__((target("sse4.2"))) inline int search_count_sse(const double *p, double key, bool upper) {
+	__m128d k = _mm_set1_pd(key);
+	int m = 0;
+	for (int i = 0; i < 8; ++i) {
+		__m128d v = _mm_loadu_pd(p + 2 * i);
+		m |= _mm_movemask_pd(upper ? _mm_cmplt_pd(k, v) : _mm_cmplt_pd(v, k)) << (2 * i);
+	}
+	return upper ? 16 - __builtin_popcount(m) : __builtin_popcount(m);
+}
+#endif
+
+/**
+ * which window kernel a type gets: the SIMD ones for 32 and 64 bit signed integers and double
+ */
+template<typename T, typename Enable = void>
+struct search_kernel {
+	typedef T lane;
+	static const bool simd = false;
+};
+template<typename T>
+struct search_kernel<T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 4>::type> {
+	typedef int32_t lane;
+	static const bool simd = true;
+};
+template<typename T>
+struct search_kernel<T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 8>::type> {
+	typedef int64_t lane;
+	static const bool simd = true;
+};
+template<>
+struct search_kernel<double> {
+	typedef double lane;
+	static const bool simd = true;
+};
+
+template<typename T>
+inline int search_count(const T *p, const T &key, bool upper, std::false_type) {
+	return search_count_scalar(p, key, upper);
+}
+template<typename T>
+inline int search_count(const T *p, const T &key, bool upper, std::true_type) {
+#ifdef SJTU_SEARCH_X86
+	typedef typename search_kernel<T>::lane lane;
+	int level = search_level();
+	if (level == 2) return search_count_avx2((const lane*) p, (lane) key, upper);
+	if (level == 1) return search_count_sse((const lane*) p, (lane) key, upper);
+#endif
+	return search_count_scalar(p, key, upper);
+}
+template<typename T>
+inline int search_count(const T *p, const T &key, bool upper) {
+	return search_count(p, key, upper, std::integral_constant<bool, search_kernel<T>::simd>());
+}
+
+/**
+ * whether x goes before the answer: x < key for a lower bound, x <= key for an upper one
+ */
+template<bool Upper, typename T>
+inline bool search_before(const T &x, const T &key) {
+	return Upper ? !(key < x) : x < key;
+}
+
+/**
+ * the first position in the sorted a[0..n) whose key is not below key, or with Upper set, is above it
+ */
+template<bool Upper, typename T>
+size_t search_bound(const T *a, size_t n, const T &key) {
+	if (n < 16) {
+		size_t ret = 0;
+		while (ret < n && search_before<Upper>(a[ret], key)) ++ret;
+		return ret;
+	}
+	const T *base = a;
+	for (size_t len = n; len > 16; ) {
+		size_t half = len / 2;
+		// fetch both places the next step may look at while this comparison is still waiting
+		__builtin_prefetch(base + half / 2);
+		__builtin_prefetch(base + half + half / 2);
+		base = search_before<Upper>(base[half], key) ? base + half : base;
+		len -= half;
+	}
+	// every key before base is on the left of the answer, so a window ending inside the array can start earlier
+	if (base > a + n - 16) base = a + n - 16;
+	return base - a + search_count(base, key, Upper);
+}
+
+/**
+ * the same search for m probes at once, in groups whose descents run in lockstep
+ * so the cache misses of different probes overlap
+ */
+template<bool Upper, typename T>
+void search_bounds(const T *a, size_t n, const T *keys, size_t m, size_t *out) {
+	const int GROUP = 8;
+	if (n < 16) {
+		for (size_t i = 0; i < m; ++i) out[i] = search_bound<Upper>(a, n, keys[i]);
+		return;
+	}
+	for (size_t i = 0; i < m; i += GROUP) {
+		int g = m - i < (size_t) GROUP ? m - i : GROUP;
+		const T *base[GROUP];
+		for (int j = 0; j < g; ++j) base[j] = a;
+		for (size_t len = n; len > 16; ) {
+			size_t half = len / 2;
+			len -= half;
+			for (int j = 0; j < g; ++j) {
+				base[j] = search_before<Upper>(base[j][half], keys[i + j]) ? base[j] + half : base[j];
+				__builtin_prefetch(base[j] + len / 2);
+			}
+		}
+		for (int j = 0; j < g; ++j) {
+			if (base[j] > a + n - 16) base[j] = a + n - 16;
+			out[i + j] = base[j] - a + search_count(base[j], keys[i + j], Upper);
+		}
+	}
+}
+
+template<typename T>
+size_t lower_bound(const vector<T> &v, const T &key) {
+	static_assert(std::is_arithmetic<T>::value, "sorted searches need arithmetic keys");
+	return search_bound<false>(v.data, v.size(), key);
+}
+template<typename T>
+size_t upper_bound(const vector<T> &v, const T &key) {
+	static_assert(std::is_arithmetic<T>::value, "sorted searches need arithmetic keys");
+	return search_bound<true>(v.data, v.size(), key);
+}
+template<typename T>
+bool contains(const vector<T> &v, const T &key) {
+	size_t p = lower_bound(v, key);
+	return p < v.size() && !(key < v.data[p]);
+}
+/**
+ * out[i] = lower_bound(v, keys[i]) for every i < m
+ */
+template<typename T>
+void lower_bound(const vector<T> &v, const T *keys, size_t m, size_t *out) {
+	static_assert(std::is_arithmetic<T>::value, "sorted searches need arithmetic keys");
+	search_bounds<false>(v.data, v.size(), keys, m, out);
+}
+template<typename T>
+void upper_bound(const vector<T> &v, const T *keys, size_t m, size_t *out) {
+	static_assert(std::is_arithmetic<T>::value, "sorted searches need arithmetic keys");
+	search_bounds<true>(v.data, v.size(), keys, m, out);
+}
+
+}
+
+#endif
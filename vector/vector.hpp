@@ -5,6 +5,7 @@
 
 #include <climits>
 #include <cstddef>
+#include <utility>
 
 namespace sjtu {
 template<typename T>
@@ -13,12 +14,15 @@ public:
 	T *data;
 	int currentLength;
 	int maxSize;
+	/**
+	 * the elements are moved, not copied, into the new buffer
+	 */
 	void doubleSpace() {
 		T *tmp = data;
-		maxSize *= 2;
+		maxSize = maxSize > 0 ? maxSize * 2 : 10;
 		data = (T*) (operator new (maxSize * sizeof(T)));
 		for (int i = 0; i < currentLength; ++i)
-			data[i] = tmp[i];
+			new(data + i) T(std::move(tmp[i]));
         for (T* p = tmp; p < tmp + currentLength; ++p)
             p->~T();
 		operator delete (tmp);
@@ -163,11 +167,21 @@ public:
 		currentLength = 0;
 	}
 	vector(const vector &other) {
-		maxSize = other.maxSize;
+		maxSize = other.maxSize > 0 ? other.maxSize : 10;
         data = (T*) (operator new (maxSize * sizeof(T)));
 		currentLength = other.currentLength;
 		for (int i = 0; i < currentLength; ++i)
-			data[i] = other.data[i];
+			new(data + i) T(other.data[i]);
+	}
+	/**
+	 * takes other's buffer and leaves other empty with none
+	 */
+	vector(vector &&other) noexcept {
+		data = other.data;
+		currentLength = other.currentLength;
+		maxSize = other.maxSize;
+		other.data = nullptr;
+		other.currentLength = other.maxSize = 0;
 	}
 	~vector() {
 	    for (T* p = data; p < data + currentLength; ++p)
@@ -179,13 +193,24 @@ public:
         for (T* p = data; p < data + currentLength; ++p)
             p->~T();
         operator delete (data);
-		maxSize = other.maxSize;
+		maxSize = other.maxSize > 0 ? other.maxSize : 10;
         data = (T*) (operator new (maxSize * sizeof(T)));
 		currentLength = other.currentLength;
 		for (int i = 0; i < currentLength; ++i)
-			data[i] = other.data[i];
+			new(data + i) T(other.data[i]);
 		return *this;
 	}
+	vector &operator=(vector &&other) noexcept {
+		if (this == &other) return *this;
+		vector tmp(std::move(other));
+		swap(tmp);
+		return *this;
+	}
+	void swap(vector &other) noexcept {
+		std::swap(data, other.data);
+		std::swap(currentLength, other.currentLength);
+		std::swap(maxSize, other.maxSize);
+	}
 	T & at(const size_t &pos) {
         if (pos < 0 || pos >= currentLength) throw index_out_of_bound();
         return data[pos];
@@ -231,9 +256,13 @@ public:
 		return currentLength;
 	}
 	void clear() {
+        for (T* p = data; p < data + currentLength; ++p)
+            p->~T();
 		currentLength = 0;
 	}
 	iterator insert(iterator pos, const T &value) {
+	    // value may be an element of this vector, which growing and shifting move
+	    T copy(value);
 	    T *q;
 	    if (currentLength == maxSize) {
 	        int offset = pos.pos - data;
@@ -241,56 +270,68 @@ public:
 	        pos.pos = data + offset;
 	    }
 	    q = data + currentLength;
-	    while (q > pos.pos) {
-	        *q = *(q - 1);
-	        --q;
+	    if (q == pos.pos) new(q) T(std::move(copy));
+	    else {
+	        new(q) T(std::move(*(q - 1)));
+	        for (--q; q > pos.pos; --q)
+	            *q = std::move(*(q - 1));
+	        *pos.pos = std::move(copy);
 	    }
-	    new(pos.pos) T(value);
 	    ++currentLength;
 	    return pos;
 	}
 	iterator insert(const size_t &ind, const T &value) {
 	    if (ind > maxSize) throw index_out_of_bound();
-	    if (currentLength == maxSize) doubleSpace();
-	    for (int i = currentLength; i > ind; --i)
-	        data[i] = data[i - 1];
-        new(data + ind) T(value);
-        ++currentLength;
-        return iterator(data + ind, this);
+	    return insert(iterator(data + ind, this), value);
 	}
 	iterator erase(iterator pos) {
 	    T *q = pos.pos;
 	    --currentLength;
 	    while (q < data + currentLength) {
-            *q = *(q + 1);
+            *q = std::move(*(q + 1));
             ++q;
 	    }
-	    T *p = data + currentLength + 1;
+	    T *p = data + currentLength;
 	    p->~T();
 	    return pos;
 	}
 	iterator erase(const size_t &ind) {
 	    if (ind >= maxSize) throw index_out_of_bound();
 	    for (int i = ind; i < currentLength - 1; ++i)
-	        data[i] = data[i + 1];
+	        data[i] = std::move(data[i + 1]);
 	    --currentLength;
-        T *p = data + currentLength + 1;
+        T *p = data + currentLength;
         p->~T();
 	    return iterator(data + ind, this);
 	}
 	void push_back(const T &value) {
+		if (currentLength == maxSize) {
+			// value may be an element of this vector, which growing moves out of the old storage
+			T copy(value);
+			doubleSpace();
+			new(data + currentLength) T(std::move(copy));
+		}
+		else new(data + currentLength) T(value);
+		currentLength++;
+	}
+	void push_back(T &&value) {
 		if (currentLength == maxSize) doubleSpace();
-        new(data + currentLength) T(value);
+        new(data + currentLength) T(std::move(value));
 		currentLength++;
 	}
 	void pop_back() {
 		if (currentLength == 0) throw container_is_empty();
 		currentLength--;
-        T *p = data + currentLength + 1;
+        T *p = data + currentLength;
         p->~T();
 	}
 };
 
+template<typename T>
+void swap(vector<T> &a, vector<T> &b) noexcept {
+	a.swap(b);
+}
+
 }
 
 #endif